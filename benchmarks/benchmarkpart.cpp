@@ -0,0 +1,47 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include <KActionCollection>
+#include <KParts/Part>
+#include <KPluginFactory>
+
+#include <QAction>
+#include <QDomDocument>
+#include <QWidget>
+
+// A part without any functionality, so the benchmarks only measure the plugin
+// interface around it
+class BenchmarkPart : public KParts::Part
+{
+    Q_OBJECT
+
+public:
+    BenchmarkPart(QWidget *parentWidget, QObject *parent, const KPluginMetaData &metaData, const QVariantList &)
+        : KParts::Part(parent, metaData)
+    {
+        setWidget(new QWidget(parentWidget));
+    }
+
+    // The benchmarks use GUI descriptions of different sizes. Every action
+    // named in it exists, so merging plugs them into the window.
+    Q_INVOKABLE void loadGuiDescription(const QString &xmlFile)
+    {
+        setXMLFile(xmlFile);
+        const QDomNodeList actions = domDocument().elementsByTagName(QStringLiteral("Action"));
+        for (int i = 0; i < actions.count(); ++i) {
+            const QString name = actions.item(i).toElement().attribute(QStringLiteral("name"));
+            if (!actionCollection()->action(name)) {
+                actionCollection()->addAction(name)->setText(name);
+            }
+        }
+    }
+};
+
+K_PLUGIN_CLASS_WITH_JSON(BenchmarkPart, "benchmarkpart.json")
+
+#include "benchmarkpart.moc"
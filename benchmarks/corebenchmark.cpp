@@ -0,0 +1,300 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "corebenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "core.h"
+#include "plugin.h"
+
+#include <KActionCollection>
+#include <KParts/Part>
+#include <KPluginFactory>
+#include <KPluginMetaData>
+
+#include <QAction>
+#include <QCoreApplication>
+#include <QDomDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <limits>
+#include <memory>
+#include <vector>
+
+QTEST_MAIN(CoreBenchmark)
+
+namespace
+{
+constexpr const char partLibrary[] = "kontactinterface_benchmark/kontactinterface_benchmarkpart";
+
+// Creates the actions named in the GUI description of client, so merging plugs them
+void createNamedActions(KXMLGUIClient *client)
+{
+    const QDomNodeList actions = client->domDocument().elementsByTagName(u"Action"_s);
+    for (int i = 0; i < actions.count(); ++i) {
+        const QString name = actions.item(i).toElement().attribute(u"name"_s);
+        if (!client->actionCollection()->action(name)) {
+            client->actionCollection()->addAction(name)->setText(name);
+        }
+    }
+}
+}
+
+class BenchmarkCore : public KontactInterface::Core
+{
+    Q_OBJECT
+
+public:
+    void selectPlugin(KontactInterface::Plugin *) override
+    {
+    }
+
+    void selectPlugin(const QString &) override
+    {
+    }
+
+    QList<KontactInterface::Plugin *> pluginList() const override
+    {
+        return {};
+    }
+
+    void partLoaded(KontactInterface::Plugin *, KParts::Part *) override
+    {
+    }
+
+    // What Kontact does when a plugin is selected
+    void mergePart(KParts::Part *part)
+    {
+        createGUI(part);
+    }
+};
+
+class BenchmarkPlugin : public KontactInterface::Plugin
+{
+    Q_OBJECT
+
+public:
+    BenchmarkPlugin(KontactInterface::Core *core, const char *name)
+        : KontactInterface::Plugin(core, core, KPluginMetaData(), name)
+    {
+        setPartLibraryName(partLibrary);
+    }
+
+    [[nodiscard]] QStringList invisibleToolbarActions() const override
+    {
+        return mHiddenActions;
+    }
+
+    // The GUI description of the plugin itself, as opposed to the one of its part
+    void loadGuiDescription(const QString &xmlFile)
+    {
+        setXMLFile(xmlFile);
+        createNamedActions(this);
+    }
+
+    QString mGuiDescription;
+    QStringList mHiddenActions;
+    // Creates a part of its own instead of sharing the one cached by the core
+    bool mOwnPart = false;
+
+protected:
+    KParts::Part *createPart() override
+    {
+        KParts::Part *part = nullptr;
+        if (mOwnPart) {
+            const KPluginMetaData metaData = KPluginMetaData::findPluginById(u"kontactinterface_benchmark"_s, u"kontactinterface_benchmarkpart"_s);
+            part = KPluginFactory::instantiatePlugin<KParts::Part>(metaData, this).plugin;
+        } else {
+            part = loadPart();
+        }
+        if (part && !mGuiDescription.isEmpty()) {
+            QMetaObject::invokeMethod(part, "loadGuiDescription", Q_ARG(QString, mGuiDescription));
+        }
+        return part;
+    }
+};
+
+CoreBenchmark::CoreBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+CoreBenchmark::~CoreBenchmark() = default;
+
+void CoreBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QCoreApplication::addLibraryPath(QStringLiteral(BENCHMARK_PLUGIN_DIR));
+    QVERIFY(mGuiDescriptions.isValid());
+    mCore = new BenchmarkCore;
+    QVERIFY(mCore->createPart(partLibrary));
+}
+
+void CoreBenchmark::cleanupTestCase()
+{
+    delete mCore;
+    mCore = nullptr;
+}
+
+QString CoreBenchmark::writeGuiDescription(int actionCount, const QString &clientName)
+{
+    // Clients with a name get actions of their own
+    const QString actionPrefix = clientName.isEmpty() ? u"action_"_s : clientName + "_action_"_L1;
+    QString actions;
+    for (int i = 0; i < actionCount; ++i) {
+        actions += "<Action name=\"%1%2\"/>\n"_L1.arg(actionPrefix).arg(i);
+    }
+    const QString xml = QStringLiteral(
+                            "<!DOCTYPE gui SYSTEM \"kpartgui.dtd\">\n"
+                            "<gui name=\"%2\" version=\"1\">\n"
+                            "<MenuBar>\n<Menu name=\"file\"><text>&amp;File</text>\n%1</Menu>\n</MenuBar>\n"
+                            "<ToolBar name=\"mainToolBar\"><text>Main Toolbar</text>\n%1</ToolBar>\n"
+                            "</gui>\n")
+                            .arg(actions, clientName.isEmpty() ? u"kontactinterface_benchmarkpart"_s : clientName);
+
+    const QString fileName = mGuiDescriptions.filePath("benchmark-%1%2.rc"_L1.arg(clientName.isEmpty() ? QString() : clientName + u'-').arg(actionCount));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(xml.toUtf8()) < 0) {
+        return {};
+    }
+    return fileName;
+}
+
+void CoreBenchmark::createPartHit()
+{
+    QBENCHMARK {
+        QVERIFY(mCore->createPart(partLibrary));
+    }
+}
+
+void CoreBenchmark::createPartMiss()
+{
+    // The library stays loaded, this measures resolving and instantiating the part
+    QBENCHMARK {
+        KParts::Part *part = mCore->createPart(partLibrary);
+        QVERIFY(part);
+        delete part;
+    }
+}
+
+void CoreBenchmark::partLoad_data()
+{
+    QTest::addColumn<int>("actionCount");
+    QTest::addColumn<bool>("rewrite");
+
+    for (int actionCount : {10, 100, 1000}) {
+        QTest::addRow("%d actions, unchanged", actionCount) << actionCount << false;
+        QTest::addRow("%d actions, rewritten", actionCount) << actionCount << true;
+    }
+}
+
+void CoreBenchmark::partLoad()
+{
+    QFETCH(int, actionCount);
+    QFETCH(bool, rewrite);
+
+    BenchmarkPlugin plugin(mCore, "benchmark");
+    plugin.mGuiDescription = writeGuiDescription(actionCount);
+    plugin.mHiddenActions = {u"action_0"_s, u"action_1"_s};
+    QVERIFY(!plugin.mGuiDescription.isEmpty());
+    delete plugin.part();
+
+    // Removing the generated GUI description forces removeInvisibleToolbarActions() to write it again
+    const QString generatedFile = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kontact/default-benchmark.rc"_L1;
+    QBENCHMARK {
+        if (rewrite) {
+            QFile::remove(generatedFile);
+        }
+        KParts::Part *part = plugin.part();
+        QVERIFY(part);
+        delete part;
+    }
+}
+
+void CoreBenchmark::switchSharedPart()
+{
+    // Like the korganizer plugins, both share one part and switch its XML files
+    BenchmarkPlugin first(mCore, "benchmark_first");
+    BenchmarkPlugin second(mCore, "benchmark_second");
+    first.mGuiDescription = writeGuiDescription(100);
+    second.mGuiDescription = first.mGuiDescription;
+    QVERIFY(first.part());
+    QCOMPARE(second.part(), first.part());
+
+    QBENCHMARK {
+        first.aboutToSelect();
+        second.aboutToSelect();
+    }
+}
+
+void CoreBenchmark::guiMerge_data()
+{
+    QTest::addColumn<int>("pluginCount");
+    QTest::addColumn<bool>("batched");
+
+    for (int pluginCount : {5, 10, 20}) {
+        QTest::addRow("%d plugins", pluginCount) << pluginCount << false;
+        QTest::addRow("%d plugins, batched", pluginCount) << pluginCount << true;
+    }
+}
+
+void CoreBenchmark::guiMerge()
+{
+    QFETCH(int, pluginCount);
+    QFETCH(bool, batched);
+
+    // Like Kontact: a shown window, plugins joining the factory once their
+    // part is loaded, and the part of the selected plugin merged at the end
+    mCore->setGuiClientsDeferred(true);
+    mCore->show();
+    QVERIFY(QTest::qWaitForWindowExposed(mCore));
+
+    // Timed by hand, so creating and tearing the plugins down does not count
+    qint64 best = std::numeric_limits<qint64>::max();
+    for (int run = 0; run < 5; ++run) {
+        std::vector<std::unique_ptr<BenchmarkPlugin>> plugins;
+        for (int i = 0; i < pluginCount; ++i) {
+            const QByteArray name = "benchmark_" + QByteArray::number(i);
+            plugins.push_back(std::make_unique<BenchmarkPlugin>(mCore, name.constData()));
+            BenchmarkPlugin *plugin = plugins.back().get();
+            plugin->mOwnPart = true;
+            plugin->mGuiDescription = writeGuiDescription(50, QString::fromLatin1(name + "_part"));
+            plugin->loadGuiDescription(writeGuiDescription(5, QString::fromLatin1(name)));
+            QVERIFY(!plugin->mGuiDescription.isEmpty());
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        if (batched) {
+            mCore->beginGuiBatch();
+        }
+        for (const auto &plugin : plugins) {
+            QVERIFY(plugin->part());
+        }
+        if (batched) {
+            mCore->endGuiBatch();
+        }
+        mCore->mergePart(plugins.front()->part());
+        // Laying out and painting the window belongs to the merge as well
+        QCoreApplication::processEvents();
+        best = std::min(best, timer.nsecsElapsed());
+
+        QVERIFY(plugins.front()->part()->factory());
+        mCore->mergePart(nullptr);
+    }
+    mCore->hide();
+    mCore->setGuiClientsDeferred(false);
+    QTest::setBenchmarkResult(best / 1000000.0, QTest::WalltimeMilliseconds);
+}
+
+#include "corebenchmark.moc"
+
+#include "moc_corebenchmark.cpp"
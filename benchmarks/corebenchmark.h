@@ -0,0 +1,40 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+#include <QTemporaryDir>
+
+class BenchmarkCore;
+
+class CoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CoreBenchmark(QObject *parent = nullptr);
+    ~CoreBenchmark() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void createPartHit();
+    void createPartMiss();
+    void partLoad_data();
+    void partLoad();
+    void switchSharedPart();
+    void guiMerge_data();
+    void guiMerge();
+
+private:
+    [[nodiscard]] QString writeGuiDescription(int actionCount, const QString &clientName = QString());
+
+    BenchmarkCore *mCore = nullptr;
+    QTemporaryDir mGuiDescriptions;
+};
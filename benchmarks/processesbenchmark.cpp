@@ -0,0 +1,53 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "processesbenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "processes.h"
+
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QTest>
+
+QTEST_GUILESS_MAIN(ProcessesBenchmark)
+
+ProcessesBenchmark::ProcessesBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+ProcessesBenchmark::~ProcessesBenchmark() = default;
+
+void ProcessesBenchmark::processesIdForName_data()
+{
+    QTest::addColumn<QString>("processName");
+    QTest::addColumn<bool>("found");
+
+    // The scan covers every process of the system either way, run it where many are running
+    QTest::addRow("running") << QFileInfo(QCoreApplication::applicationFilePath()).fileName() << true;
+    QTest::addRow("not running") << u"kontactinterface-no-such-process"_s << false;
+}
+
+void ProcessesBenchmark::processesIdForName()
+{
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
+    QFETCH(QString, processName);
+    QFETCH(bool, found);
+
+    QBENCHMARK {
+        QList<int> pids;
+        KontactInterface::getProcessesIdForName(processName, pids);
+        QCOMPARE(pids.contains(int(QCoreApplication::applicationPid())), found);
+    }
+#else
+    QSKIP("No process list on this platform");
+#endif
+}
+
+#include "moc_processesbenchmark.cpp"
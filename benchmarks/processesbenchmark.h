@@ -0,0 +1,24 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class ProcessesBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProcessesBenchmark(QObject *parent = nullptr);
+    ~ProcessesBenchmark() override;
+
+private Q_SLOTS:
+    void processesIdForName_data();
+    void processesIdForName();
+};
@@ -0,0 +1,105 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "summarybenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "summary.h"
+#include "summarytesthook_p.h"
+
+#include <QGridLayout>
+#include <QTest>
+
+QTEST_MAIN(SummaryBenchmark)
+
+using KontactInterface::SummaryTestHook;
+
+enum class Method {
+    // The old way: grab the whole widget and scale the result down
+    GrabAndScale,
+    // Summary rendering its drag pixmap, as on the first drag after a change
+    Render,
+    // Summary handing out the pixmap of the previous drag
+    Cached,
+};
+Q_DECLARE_METATYPE(Method)
+
+namespace
+{
+QPixmap grabAndScale(QWidget *widget)
+{
+    const QPixmap pm = widget->grab();
+    return QPixmap::fromImage(pm.toImage().scaled(300, 300, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+}
+
+SummaryBenchmark::SummaryBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SummaryBenchmark::~SummaryBenchmark() = default;
+
+void SummaryBenchmark::dragThumbnail_data()
+{
+    QTest::addColumn<int>("rowCount");
+    QTest::addColumn<int>("width");
+    QTest::addColumn<Method>("method");
+
+    // Below and above the width at which Summary scales its pixmap down
+    for (int width : {250, 800}) {
+        for (int rowCount : {10, 50, 200}) {
+            QTest::addRow("%d px, %d rows, grab and scale", width, rowCount) << rowCount << width << Method::GrabAndScale;
+            QTest::addRow("%d px, %d rows, render", width, rowCount) << rowCount << width << Method::Render;
+            QTest::addRow("%d px, %d rows, cached", width, rowCount) << rowCount << width << Method::Cached;
+        }
+    }
+}
+
+void SummaryBenchmark::dragThumbnail()
+{
+    QFETCH(int, rowCount);
+    QFETCH(int, width);
+    QFETCH(Method, method);
+
+    KontactInterface::Summary summary(nullptr);
+    auto layout = new QGridLayout(&summary);
+    summary.setRowLayout(layout);
+    QList<KontactInterface::Summary::Row> rows;
+    for (int i = 0; i < rowCount; ++i) {
+        rows.append({u"row%1"_s.arg(i), QString(), {u"Appointment %1"_s.arg(i), u"10:00 - 11:00"_s}, QString()});
+    }
+    summary.setRows(rows);
+    summary.resize(width, 20 * rowCount);
+    summary.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&summary));
+    // Let the layout settle, it drops the cached pixmap
+    QCoreApplication::processEvents();
+    if (method == Method::Cached) {
+        QVERIFY(!SummaryTestHook::dragPixmap(&summary).isNull());
+    }
+
+    QBENCHMARK {
+        QPixmap pm;
+        switch (method) {
+        case Method::GrabAndScale:
+            pm = grabAndScale(&summary);
+            break;
+        case Method::Render:
+            SummaryTestHook::clearDragPixmap(&summary);
+            pm = SummaryTestHook::dragPixmap(&summary);
+            break;
+        case Method::Cached:
+            pm = SummaryTestHook::dragPixmap(&summary);
+            break;
+        }
+        QVERIFY(!pm.isNull());
+    }
+}
+
+#include "moc_summarybenchmark.cpp"
@@ -0,0 +1,24 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class SummaryBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SummaryBenchmark(QObject *parent = nullptr);
+    ~SummaryBenchmark() override;
+
+private Q_SLOTS:
+    void dragThumbnail_data();
+    void dragThumbnail();
+};
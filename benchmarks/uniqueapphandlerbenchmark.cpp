@@ -0,0 +1,236 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "uniqueapphandlerbenchmark.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "core.h"
+#include "plugin.h"
+#include "uniqueapphandler.h"
+
+#include <KPluginMetaData>
+
+#include <QCommandLineParser>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <algorithm>
+
+QTEST_MAIN(UniqueAppHandlerBenchmark)
+
+namespace
+{
+// Runs against a private bus, so no real application owns this name
+constexpr const char appName[] = "kontactinterfacebenchmark";
+
+// Blocking calls would not let the handler, living in this thread, answer
+bool callAndWait(const QDBusConnection &connection, const QDBusMessage &message)
+{
+    QDBusPendingCallWatcher watcher(connection.asyncCall(message));
+    QEventLoop loop;
+    QObject::connect(&watcher, &QDBusPendingCallWatcher::finished, &loop, &QEventLoop::quit);
+    if (!watcher.isFinished()) {
+        loop.exec();
+    }
+    return !watcher.isError();
+}
+
+QString serviceName()
+{
+    return "org.kde."_L1 + QLatin1StringView(appName);
+}
+
+QDBusMessage newInstanceMessage()
+{
+    QDBusMessage message = QDBusMessage::createMethodCall(serviceName(),
+                                                          u"/"_s + QLatin1StringView(appName) + "_PimApplication"_L1,
+                                                          u"org.kde.PIMUniqueApplication"_s,
+                                                          u"newInstance"_s);
+    message << QByteArray() << QStringList{u"kmail"_s, u"--subject"_s, u"Hello"_s, u"mailto:someone@example.org"_s} << QString();
+    return message;
+}
+}
+
+class BenchmarkCore : public KontactInterface::Core
+{
+    Q_OBJECT
+
+public:
+    void selectPlugin(KontactInterface::Plugin *) override
+    {
+    }
+
+    void selectPlugin(const QString &) override
+    {
+    }
+
+    QList<KontactInterface::Plugin *> pluginList() const override
+    {
+        return {};
+    }
+
+    void partLoaded(KontactInterface::Plugin *, KParts::Part *) override
+    {
+    }
+};
+
+class BenchmarkPlugin : public KontactInterface::Plugin
+{
+    Q_OBJECT
+
+public:
+    explicit BenchmarkPlugin(KontactInterface::Core *core)
+        : KontactInterface::Plugin(core, core, KPluginMetaData(), appName)
+    {
+    }
+
+protected:
+    KParts::Part *createPart() override
+    {
+        return nullptr;
+    }
+};
+
+class BenchmarkHandler : public KontactInterface::UniqueAppHandler
+{
+    Q_OBJECT
+
+public:
+    using KontactInterface::UniqueAppHandler::UniqueAppHandler;
+
+    void loadCommandLineOptions(QCommandLineParser *parser) override
+    {
+        parser->addPositionalArgument(u"url"_s, u"A URL to open"_s);
+        parser->addOption(QCommandLineOption({u"c"_s, u"composer"_s}, u"Open a composer"_s));
+        parser->addOption(QCommandLineOption({u"s"_s, u"subject"_s}, u"The subject"_s, u"subject"_s));
+    }
+
+protected:
+    // Measures the handler, not showing and selecting the plugin
+    int activate(const QStringList &, const QString &) override
+    {
+        return 0;
+    }
+};
+
+UniqueAppHandlerBenchmark::UniqueAppHandlerBenchmark(QObject *parent)
+    : QObject(parent)
+{
+}
+
+UniqueAppHandlerBenchmark::~UniqueAppHandlerBenchmark() = default;
+
+void UniqueAppHandlerBenchmark::initTestCase()
+{
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(QDBusConnection::sessionBus().isConnected());
+    mCore = new BenchmarkCore;
+    mPlugin = new BenchmarkPlugin(mCore);
+}
+
+void UniqueAppHandlerBenchmark::cleanupTestCase()
+{
+    delete mCore;
+    mCore = nullptr;
+    mPlugin = nullptr;
+}
+
+void UniqueAppHandlerBenchmark::createWatcher()
+{
+    // Nothing runs standalone, so every watcher also creates the handler
+    QBENCHMARK {
+        auto watcher = new KontactInterface::UniqueAppWatcher(new KontactInterface::UniqueAppHandlerFactory<BenchmarkHandler>(), mPlugin);
+        QVERIFY(!watcher->isRunningStandalone());
+        delete watcher;
+        // The handler belongs to the plugin
+        qDeleteAll(mPlugin->findChildren<KontactInterface::UniqueAppHandler *>());
+    }
+}
+
+void UniqueAppHandlerBenchmark::newInstance()
+{
+    const auto watcher = std::make_unique<KontactInterface::UniqueAppWatcher>(new KontactInterface::UniqueAppHandlerFactory<BenchmarkHandler>(), mPlugin);
+    QTRY_VERIFY(QDBusConnection::sessionBus().interface()->isServiceRegistered(serviceName()));
+    const QDBusMessage message = newInstanceMessage();
+
+    // The call is made on a second connection, since the handler lives on the first one
+    QDBusConnection client = QDBusConnection::connectToBus(QDBusConnection::SessionBus, u"client"_s);
+    QVERIFY(client.isConnected());
+    QBENCHMARK {
+        QVERIFY(callAndWait(client, message));
+    }
+    QDBusConnection::disconnectFromBus(u"client"_s);
+    qDeleteAll(mPlugin->findChildren<KontactInterface::UniqueAppHandler *>());
+}
+
+void UniqueAppHandlerBenchmark::newInstanceBurst_data()
+{
+    QTest::addColumn<int>("callCount");
+
+    QTest::addRow("1000 calls") << 1000;
+    QTest::addRow("5000 calls") << 5000;
+}
+
+void UniqueAppHandlerBenchmark::newInstanceBurst()
+{
+    QFETCH(int, callCount);
+
+    const auto watcher = std::make_unique<KontactInterface::UniqueAppWatcher>(new KontactInterface::UniqueAppHandlerFactory<BenchmarkHandler>(), mPlugin);
+    QTRY_VERIFY(QDBusConnection::sessionBus().interface()->isServiceRegistered(serviceName()));
+    const QDBusMessage message = newInstanceMessage();
+    QDBusConnection client = QDBusConnection::connectToBus(QDBusConnection::SessionBus, u"client"_s);
+    QVERIFY(client.isConnected());
+
+    // Like a desktop opening many mailto: links at once, all calls are sent before any reply
+    QList<qint64> latencies;
+    latencies.reserve(callCount);
+    int pending = callCount;
+    int failures = 0;
+    QEventLoop loop;
+    QElapsedTimer clock;
+    clock.start();
+    for (int i = 0; i < callCount; ++i) {
+        const qint64 sent = clock.nsecsElapsed();
+        auto call = new QDBusPendingCallWatcher(client.asyncCall(message), this);
+        connect(call, &QDBusPendingCallWatcher::finished, &loop, [&, sent](QDBusPendingCallWatcher *finished) {
+            finished->deleteLater();
+            if (finished->isError()) {
+                ++failures;
+            }
+            latencies.append(clock.nsecsElapsed() - sent);
+            if (--pending == 0) {
+                loop.quit();
+            }
+        });
+    }
+    if (pending > 0) {
+        loop.exec();
+    }
+    const qint64 total = clock.elapsed();
+    QDBusConnection::disconnectFromBus(u"client"_s);
+    qDeleteAll(mPlugin->findChildren<KontactInterface::UniqueAppHandler *>());
+    QCOMPARE(failures, 0);
+
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](int percent) {
+        return latencies.at(std::min<qsizetype>(latencies.size() - 1, latencies.size() * percent / 100)) / 1000;
+    };
+    qInfo() << callCount << "calls in" << total << "ms, latency in us p50:" << percentile(50) << "p90:" << percentile(90) << "p99:" << percentile(99)
+            << "max:" << latencies.constLast() / 1000;
+    QTest::setBenchmarkResult(total, QTest::WalltimeMilliseconds);
+}
+
+#include "uniqueapphandlerbenchmark.moc"
+
+#include "moc_uniqueapphandlerbenchmark.cpp"
@@ -0,0 +1,35 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QObject>
+
+class BenchmarkCore;
+class BenchmarkPlugin;
+
+class UniqueAppHandlerBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UniqueAppHandlerBenchmark(QObject *parent = nullptr);
+    ~UniqueAppHandlerBenchmark() override;
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void createWatcher();
+    void newInstance();
+    void newInstanceBurst_data();
+    void newInstanceBurst();
+
+private:
+    BenchmarkCore *mCore = nullptr;
+    BenchmarkPlugin *mPlugin = nullptr;
+};
@@ -9,31 +9,38 @@
 */
 
 #include "core.h"
+#include "core_p.h"
 #include "kontactinterface_debug.h"
+#include "partevictor_p.h"
+#include "partpreloader_p.h"
+#include "plugin.h"
+#include "pluginmetadatacache_p.h"
+#include "tracing_p.h"
+#include "usagepredictor_p.h"
+#include "wallclockscheduler_p.h"
 
 #include <KPluginFactory>
 #include <KPluginMetaData>
+#include <KXMLGUIFactory>
 
-#include <QDateTime>
-#include <QTimer>
+#include <QElapsedTimer>
+#include <QPluginLoader>
+#include <QPromise>
+#include <QThreadPool>
 
 using namespace KontactInterface;
 
 //@cond PRIVATE
-class Q_DECL_HIDDEN KontactInterface::CorePrivate
+static PartLibrary resolvePartLibrary(const QByteArray &libname)
 {
-    Core *const q;
-
-public:
-    explicit CorePrivate(Core *qq);
-
-    void slotPartDestroyed(QObject *);
-    void checkNewDay();
-
-    QString lastErrorMessage;
-    QDate mLastDate;
-    QMap<QByteArray, KParts::Part *> mParts;
-};
+    PartLibrary library;
+    PluginMetaDataCache *cache = PluginMetaDataCache::self();
+    if (!cache->lookup(libname, library.metaData, library.errorString)) {
+        library.metaData = KPluginMetaData(QString::fromLatin1(libname));
+        cache->insert(libname, library.metaData);
+    }
+    return library;
+}
 
 CorePrivate::CorePrivate(Core *qq)
     : q(qq)
@@ -46,51 +53,218 @@ Core::Core(QWidget *parent, Qt::WindowFlags f)
     : KParts::MainWindow(parent, f)
     , d(new CorePrivate(this))
 {
-    auto timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, this, [this]() {
+    d->mScheduler = new WallClockScheduler(this);
+    connect(d->mScheduler, &WallClockScheduler::clockChanged, this, [this]() {
         d->checkNewDay();
+        d->scheduleDayChange();
     });
-    timer->start(1000 * 60);
+    d->scheduleDayChange();
+    d->mPredictor = new UsagePredictor(this);
 }
 
 Core::~Core() = default;
 
 KParts::Part *Core::createPart(const char *libname)
 {
+    const TraceSpan span("Core::createPart", libname);
     qCDebug(KONTACTINTERFACE_LOG) << libname;
 
-    QMap<QByteArray, KParts::Part *>::ConstIterator it;
-    it = d->mParts.constFind(libname);
+    const auto it = d->mParts.constFind(libname);
     if (it != d->mParts.constEnd()) {
-        return it.value();
+        return it->part;
     }
 
     qCDebug(KONTACTINTERFACE_LOG) << "Creating new KPart";
-    const auto result = KPluginFactory::instantiatePlugin<KParts::Part>(KPluginMetaData(QString::fromLatin1(libname)), this);
+    return d->instantiatePart(libname, resolvePartLibrary(libname));
+}
+
+QFuture<KParts::Part *> Core::createPartAsync(const char *libname)
+{
+    qCDebug(KONTACTINTERFACE_LOG) << libname;
+
+    const QByteArray library(libname);
+    const auto it = d->mParts.constFind(library);
+    if (it != d->mParts.constEnd()) {
+        return QtFuture::makeReadyValueFuture(it->part);
+    }
+    const auto pending = d->mPendingParts.constFind(library);
+    if (pending != d->mPendingParts.constEnd()) {
+        return pending.value();
+    }
+
+    qCDebug(KONTACTINTERFACE_LOG) << "Loading KPart library in the background";
+    auto promise = std::make_shared<QPromise<PartLibrary>>();
+    const QFuture<PartLibrary> loaded = promise->future();
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, library]() {
+        const TraceSpan span("Core::createPartAsync load", library.constData());
+        // Resolving the plugin path, reading its metadata and running the static
+        // initializers of the library is what blocks. The library stays loaded
+        // afterwards, so instantiatePlugin() only has to look up the factory.
+        const PartLibrary partLibrary = resolvePartLibrary(library);
+        const KPluginMetaData &metaData = partLibrary.metaData;
+        if (metaData.isValid() && !metaData.isStaticPlugin()) {
+            QPluginLoader loader(metaData.fileName());
+            if (!loader.load()) {
+                qCDebug(KONTACTINTERFACE_LOG) << "Preloading" << library << "failed:" << loader.errorString();
+            }
+        }
+        promise->addResult(partLibrary);
+        promise->finish();
+    });
+
+    const QFuture<KParts::Part *> part = loaded.then(this, [this, library](const PartLibrary &partLibrary) {
+        d->mPendingParts.remove(library);
+        // createPart() might have been called for the same library in the meantime
+        const auto existing = d->mParts.constFind(library);
+        if (existing != d->mParts.constEnd()) {
+            return existing->part;
+        }
+        return d->instantiatePart(library, partLibrary);
+    });
+    d->mPendingParts.insert(library, part);
+    return part;
+}
+
+//@cond PRIVATE
+KParts::Part *CorePrivate::instantiatePart(const QByteArray &libname, const PartLibrary &library)
+{
+    const TraceSpan span("Core::instantiatePart", libname.constData());
+    if (!library.errorString.isEmpty()) {
+        // Known to fail, don't try loading it again
+        lastErrorMessage = library.errorString;
+        qCWarning(KONTACTINTERFACE_LOG) << lastErrorMessage;
+        return nullptr;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto result = KPluginFactory::instantiatePlugin<KParts::Part>(library.metaData, q);
     if (result.plugin) {
-        d->mParts.insert(libname, result.plugin);
-        QObject::connect(result.plugin, &KParts::Part::destroyed, this, [this](QObject *obj) {
-            d->slotPartDestroyed(obj);
+        PartEntry &entry = mParts[libname];
+        entry.part = result.plugin;
+        entry.loadTime = QDateTime::currentDateTime();
+        entry.loadDuration = timer.elapsed();
+        entry.lastUsed.start();
+        mPartLibraries.insert(result.plugin, libname);
+        QObject::connect(result.plugin, &KParts::Part::destroyed, q, [this](QObject *obj) {
+            slotPartDestroyed(obj);
         });
+        if (mEvictor) {
+            mEvictor->scheduleCheck();
+        }
     } else {
-        d->lastErrorMessage = result.errorString;
-        qCWarning(KONTACTINTERFACE_LOG) << d->lastErrorMessage;
+        lastErrorMessage = result.errorString;
+        qCWarning(KONTACTINTERFACE_LOG) << lastErrorMessage;
+        PluginMetaDataCache::self()->insertFailure(libname, library.metaData.fileName(), lastErrorMessage);
     }
     return result.plugin;
 }
 
-//@cond PRIVATE
+void CorePrivate::registerPartUser(Plugin *plugin, KParts::Part *part)
+{
+    const auto library = mPartLibraries.constFind(part);
+    if (library == mPartLibraries.constEnd()) {
+        // Not created through createPart()
+        return;
+    }
+    PartEntry &entry = mParts[library.value()];
+    if (entry.users.contains(plugin)) {
+        return;
+    }
+    entry.users.insert(plugin);
+    entry.lastUsed.start();
+    // Parts come and go with eviction, the plugin is only watched once
+    if (!mConnectedPlugins.contains(plugin)) {
+        mConnectedPlugins.insert(plugin);
+        QObject::connect(plugin, &QObject::destroyed, q, [this, plugin]() {
+            for (PartEntry &partEntry : mParts) {
+                partEntry.users.remove(plugin);
+            }
+            mUnloadedPlugins.remove(plugin);
+            mConnectedPlugins.remove(plugin);
+        });
+    }
+
+    // The part is back after being unloaded, restore what the plugin saved
+    if (mUnloadedPlugins.remove(plugin)) {
+        KConfigGroup group = PartEvictor::stateGroup(plugin);
+        plugin->readProperties(group);
+        group.deleteGroup();
+    }
+}
+
+void CorePrivate::pluginSelected(Plugin *plugin)
+{
+    mSelectedPlugin = plugin;
+    for (PartEntry &entry : mParts) {
+        if (entry.users.contains(plugin)) {
+            entry.lastUsed.start();
+        }
+    }
+    mPredictor->recordSelection(plugin);
+}
+
+void CorePrivate::addGuiClient(Plugin *plugin)
+{
+    if (mGuiBatchDepth > 0) {
+        mPendingGuiClients.append(plugin);
+        return;
+    }
+    q->factory()->addClient(plugin);
+}
+
+void CorePrivate::replaceXmlFile(KParts::Part *part, const QString &xmlFile, const QString &localXmlFile)
+{
+    if (mGuiBatchDepth > 0) {
+        // Only the last replacement of a part matters
+        mPendingXmlFiles.removeIf([part](const XmlFileReplacement &replacement) {
+            return replacement.part == part;
+        });
+        XmlFileReplacement replacement;
+        replacement.part = part;
+        replacement.xmlFile = xmlFile;
+        replacement.localXmlFile = localXmlFile;
+        mPendingXmlFiles.append(replacement);
+        return;
+    }
+    part->replaceXMLFile(xmlFile, localXmlFile);
+}
+
+void CorePrivate::applyGuiBatch()
+{
+    const TraceSpan span("Core::endGuiBatch");
+    const QList<XmlFileReplacement> xmlFiles = std::exchange(mPendingXmlFiles, {});
+    const QList<QPointer<Plugin>> clients = std::exchange(mPendingGuiClients, {});
+    if (xmlFiles.isEmpty() && clients.isEmpty()) {
+        return;
+    }
+
+    // The factory merges client by client, at least the window is laid out and painted once
+    const bool updatesEnabled = q->updatesEnabled();
+    q->setUpdatesEnabled(false);
+    // The XML files first, parts that are not merged yet take them without a rebuild
+    for (const XmlFileReplacement &replacement : xmlFiles) {
+        if (replacement.part) {
+            replacement.part->replaceXMLFile(replacement.xmlFile, replacement.localXmlFile);
+        }
+    }
+    KXMLGUIFactory *factory = q->factory();
+    for (const QPointer<Plugin> &plugin : clients) {
+        if (plugin && !plugin->factory()) {
+            factory->addClient(plugin);
+        }
+    }
+    q->setUpdatesEnabled(updatesEnabled);
+}
+
 void CorePrivate::slotPartDestroyed(QObject *obj)
 {
     // the part was deleted, we need to remove it from the part map to not return
     // a dangling pointer in createPart
-    const QMap<QByteArray, KParts::Part *>::Iterator end = mParts.end();
-    QMap<QByteArray, KParts::Part *>::Iterator it = mParts.begin();
-    for (; it != end; ++it) {
-        if (it.value() == obj) {
-            mParts.erase(it);
-            return;
-        }
+    const QByteArray libname = mPartLibraries.take(obj);
+    if (!libname.isNull()) {
+        mParts.remove(libname);
     }
 }
 
@@ -102,11 +276,107 @@ void CorePrivate::checkNewDay()
 
     mLastDate = QDate::currentDate();
 }
+
+void CorePrivate::scheduleDayChange()
+{
+    if (mDayChangeAlarm) {
+        mScheduler->cancel(mDayChangeAlarm);
+    }
+    mDayChangeAlarm = mScheduler->schedule(QDate::currentDate().addDays(1).startOfDay(), q, [this]() {
+        mDayChangeAlarm = 0;
+        checkNewDay();
+        scheduleDayChange();
+    });
+}
 //@endcond
 
+int Core::notifyAt(const QDateTime &dateTime, QObject *context, const std::function<void()> &callback)
+{
+    return d->mScheduler->schedule(dateTime, context, callback);
+}
+
+void Core::cancelNotification(int id)
+{
+    d->mScheduler->cancel(id);
+}
+
+void Core::schedulePreload(std::chrono::milliseconds timeBudget, qint64 memoryBudget)
+{
+    if (!d->mPreloader) {
+        d->mPreloader = new PartPreloader(this);
+    }
+    d->mPreloader->start(timeBudget, memoryBudget);
+}
+
+void Core::cancelPreload()
+{
+    if (d->mPreloader) {
+        d->mPreloader->stop();
+    }
+}
+
+void Core::setPartEviction(std::chrono::milliseconds idleTimeout, qint64 memoryBudget)
+{
+    if (!d->mEvictor) {
+        d->mEvictor = new PartEvictor(this, d.get());
+    }
+    d->mEvictor->setLimits(idleTimeout, memoryBudget);
+}
+
+void Core::beginGuiBatch()
+{
+    ++d->mGuiBatchDepth;
+}
+
+void Core::endGuiBatch()
+{
+    if (d->mGuiBatchDepth == 0) {
+        qCWarning(KONTACTINTERFACE_LOG) << "endGuiBatch() called without beginGuiBatch()";
+        return;
+    }
+    if (--d->mGuiBatchDepth == 0) {
+        d->applyGuiBatch();
+    }
+}
+
+void Core::setGuiClientsDeferred(bool deferred)
+{
+    d->mGuiClientsDeferred = deferred;
+}
+
+bool Core::guiClientsDeferred() const
+{
+    return d->mGuiClientsDeferred;
+}
+
+void Core::setPredictivePreloadEnabled(bool enabled)
+{
+    d->mPredictor->setPreloadEnabled(enabled);
+}
+
+int Core::predictionHits() const
+{
+    return d->mPredictor->hits();
+}
+
+int Core::predictionMisses() const
+{
+    return d->mPredictor->misses();
+}
+
 QString Core::lastErrorMessage() const
 {
     return d->lastErrorMessage;
 }
 
+QList<Core::PartInfo> Core::loadedParts() const
+{
+    QList<PartInfo> parts;
+    parts.reserve(d->mParts.size());
+    for (auto it = d->mParts.constBegin(); it != d->mParts.constEnd(); ++it) {
+        parts.append({it.key(), it->part, it->loadTime, it->loadDuration, int(it->users.size())});
+    }
+    return parts;
+}
+
 #include "moc_core.cpp"
@@ -14,6 +14,12 @@
 #include <KParts/MainWindow>
 #include <KParts/Part>
 
+#include <QDateTime>
+#include <QFuture>
+
+#include <chrono>
+#include <functional>
+
 namespace KontactInterface
 {
 class Plugin;
@@ -31,6 +37,40 @@ class KONTACTINTERFACE_EXPORT Core : public KParts::MainWindow
     Q_OBJECT
 
 public:
+    /*!
+     * \class KontactInterface::Core::PartInfo
+     * \inmodule KontactInterface
+     * \brief Information about a part loaded through createPart().
+     * \since 6.8
+     */
+    struct PartInfo {
+        /*!
+         * \variable KontactInterface::Core::PartInfo::library
+         * The library the part was created from.
+         */
+        QByteArray library;
+        /*!
+         * \variable KontactInterface::Core::PartInfo::part
+         * The part itself.
+         */
+        KParts::Part *part = nullptr;
+        /*!
+         * \variable KontactInterface::Core::PartInfo::loadTime
+         * When the part was created.
+         */
+        QDateTime loadTime;
+        /*!
+         * \variable KontactInterface::Core::PartInfo::loadDuration
+         * How long creating the part took, in milliseconds.
+         */
+        qint64 loadDuration = 0;
+        /*!
+         * \variable KontactInterface::Core::PartInfo::shareCount
+         * The number of plugins using the part.
+         */
+        int shareCount = 0;
+    };
+
     /*!
      * Destroys the core object.
      */
@@ -65,6 +105,20 @@ public:
      */
     [[nodiscard]] KParts::Part *createPart(const char *library);
 
+    /*!
+     * \internal (for Plugin)
+     *
+     * \a library the library to create part from
+     * Creates a part from the given \a library without blocking the event loop.
+     *
+     * The library is resolved and loaded in a worker thread, the part itself is
+     * constructed in the main thread afterwards. Concurrent requests for the same
+     * \a library share one future. Its result is nullptr if the part could not be
+     * created, lastErrorMessage() returns the reason then.
+     * \since 6.8
+     */
+    [[nodiscard]] QFuture<KParts::Part *> createPartAsync(const char *library);
+
     /*!
      * \internal (for Plugin)
      *
@@ -72,6 +126,136 @@ public:
      */
     virtual void partLoaded(Plugin *plugin, KParts::Part *part) = 0;
 
+    /*!
+     * Returns the parts currently held by the core, e.g. to see what
+     * a long-running session keeps in memory.
+     * \since 6.8
+     */
+    [[nodiscard]] QList<KontactInterface::Core::PartInfo> loadedParts() const;
+
+    /*!
+     * Calls \a callback once the wall clock reaches \a dateTime, unless
+     * \a context has been destroyed by then.
+     *
+     * All notifications share one timer. Unlike a QTimer they follow changes of
+     * the system clock and of the time zone, and notifications whose time passed
+     * while the system was suspended are delivered on resume.
+     *
+     * Returns an identifier to be passed to cancelNotification().
+     * \since 6.8
+     */
+    int notifyAt(const QDateTime &dateTime, QObject *context, const std::function<void()> &callback);
+
+    /*!
+     * Cancels the notification \a id returned by notifyAt().
+     * \since 6.8
+     */
+    void cancelNotification(int id);
+
+    /*!
+     * Loads the parts of all plugins in the background, so that selecting
+     * a plugin the first time does not have to wait for it.
+     *
+     * Parts are loaded one at a time in weight() order, each only after the user
+     * has not used mouse or keyboard for a few seconds. Disabled plugins and
+     * plugins whose application is running standalone are skipped. Preloading
+     * stops once loading took \a timeBudget in total, or once the resident
+     * memory of the process grew by \a memoryBudget bytes (0 for no limit).
+     *
+     * Call this once all plugins are loaded.
+     * \since 6.8
+     */
+    void schedulePreload(std::chrono::milliseconds timeBudget = std::chrono::seconds(10), qint64 memoryBudget = 256 * 1024 * 1024);
+
+    /*!
+     * Stops preloading parts started with schedulePreload().
+     * \since 6.8
+     */
+    void cancelPreload();
+
+    /*!
+     * Sets when parts are unloaded to give their memory back.
+     *
+     * The part of a plugin that has not been selected for \a idleTimeout is
+     * deleted, and while the resident memory of the process exceeds
+     * \a memoryBudget bytes the least recently used parts are deleted as well.
+     * A value of 0 disables the respective limit, which is the default.
+     *
+     * A part is kept while it is visible, while it belongs to the selected
+     * plugin, or while a plugin using it returns false from
+     * Plugin::queryClose(). Before unloading, the plugins using the part get
+     * Plugin::saveProperties() called, and Plugin::readProperties() once
+     * Plugin::part() loaded the part again.
+     * \since 6.8
+     */
+    void setPartEviction(std::chrono::milliseconds idleTimeout, qint64 memoryBudget = 0);
+
+    /*!
+     * Sets whether plugins created from now on add their GUI client to the
+     * factory only once they are used.
+     *
+     * If \a deferred, a plugin is merged into the GUI when it is about to be
+     * selected or its part is loaded, instead of in its constructor, so
+     * starting up does not merge the GUI of every plugin. Actions a plugin
+     * defines in its own XML GUI description only show up from then on, its
+     * newActions() and syncActions() are available right away. The default is
+     * false.
+     * \since 6.8
+     */
+    void setGuiClientsDeferred(bool deferred);
+
+    /*!
+     * Returns whether plugins add their GUI client to the factory only once
+     * they are used.
+     * \since 6.8
+     */
+    [[nodiscard]] bool guiClientsDeferred() const;
+
+    /*!
+     * Starts collecting changes to the GUI of the plugins.
+     *
+     * Until the matching endGuiBatch(), plugins that add their GUI client to
+     * the factory and parts that switch their XML GUI files only queue the
+     * change. Calls can be nested.
+     * \sa endGuiBatch()
+     * \since 6.8
+     */
+    void beginGuiBatch();
+
+    /*!
+     * Applies the GUI changes collected since beginGuiBatch() in one go, with
+     * the window updates suspended meanwhile. When the XML files of a part
+     * were switched several times, only the latest switch is applied.
+     * \since 6.8
+     */
+    void endGuiBatch();
+
+    /*!
+     * Sets whether the parts the user is likely to select next are loaded
+     * ahead of time.
+     *
+     * The core always learns in which order the user switches between plugins,
+     * the history is kept in the state config. If \a enabled, the parts most
+     * likely selected next are loaded in the background shortly after startup
+     * and after each switch.
+     * \since 6.8
+     */
+    void setPredictivePreloadEnabled(bool enabled);
+
+    /*!
+     * Returns how often the selected plugin was among the predicted ones in
+     * this session.
+     * \since 6.8
+     */
+    [[nodiscard]] int predictionHits() const;
+
+    /*!
+     * Returns how often the selected plugin was not among the predicted ones in
+     * this session.
+     * \since 6.8
+     */
+    [[nodiscard]] int predictionMisses() const;
+
 Q_SIGNALS:
     /*!
      * This signal is emitted whenever a new day starts.
@@ -97,6 +281,7 @@ protected:
 
 private:
     friend class CorePrivate;
+    friend class Plugin;
     std::unique_ptr<CorePrivate> const d;
 };
 
@@ -0,0 +1,92 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2001 Matthias Hoelzer-Kluepfel <mhk@kde.org>
+  SPDX-FileCopyrightText: 2002-2003 Daniel Molkentin <molkentin@kde.org>
+  SPDX-FileCopyrightText: 2003 Cornelius Schumacher <schumacher@kde.org>
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "core.h"
+
+#include <KPluginMetaData>
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
+namespace KontactInterface
+{
+class PartEvictor;
+class PartPreloader;
+class UsagePredictor;
+class WallClockScheduler;
+
+//@cond PRIVATE
+struct PartLibrary {
+    KPluginMetaData metaData;
+    // Set instead of metaData when the library is known to fail loading
+    QString errorString;
+};
+
+class Q_DECL_HIDDEN CorePrivate
+{
+    Core *const q;
+
+public:
+    explicit CorePrivate(Core *qq);
+
+    KParts::Part *instantiatePart(const QByteArray &libname, const PartLibrary &library);
+    void registerPartUser(Plugin *plugin, KParts::Part *part);
+    void pluginSelected(Plugin *plugin);
+    void addGuiClient(Plugin *plugin);
+    void replaceXmlFile(KParts::Part *part, const QString &xmlFile, const QString &localXmlFile);
+    void applyGuiBatch();
+    void slotPartDestroyed(QObject *);
+    void checkNewDay();
+    void scheduleDayChange();
+
+    struct XmlFileReplacement {
+        QPointer<KParts::Part> part;
+        QString xmlFile;
+        QString localXmlFile;
+    };
+
+    struct PartEntry {
+        KParts::Part *part = nullptr;
+        QDateTime loadTime;
+        qint64 loadDuration = 0;
+        // Restarted whenever one of the users is selected
+        QElapsedTimer lastUsed;
+        QSet<Plugin *> users;
+    };
+
+    QString lastErrorMessage;
+    QDate mLastDate;
+    WallClockScheduler *mScheduler = nullptr;
+    int mDayChangeAlarm = 0;
+    PartPreloader *mPreloader = nullptr;
+    UsagePredictor *mPredictor = nullptr;
+    PartEvictor *mEvictor = nullptr;
+    bool mGuiClientsDeferred = false;
+    // GUI changes queued between beginGuiBatch() and endGuiBatch()
+    int mGuiBatchDepth = 0;
+    QList<QPointer<Plugin>> mPendingGuiClients;
+    QList<XmlFileReplacement> mPendingXmlFiles;
+    QPointer<Plugin> mSelectedPlugin;
+    // Plugins whose part was unloaded, they read their properties back on reload
+    QSet<const Plugin *> mUnloadedPlugins;
+    // Plugins whose destruction is already tracked
+    QSet<const Plugin *> mConnectedPlugins;
+    // Loaded parts by library name, plus the reverse index used on teardown
+    QHash<QByteArray, PartEntry> mParts;
+    QHash<const QObject *, QByteArray> mPartLibraries;
+    QHash<QByteArray, QFuture<KParts::Part *>> mPendingParts;
+};
+//@endcond
+}
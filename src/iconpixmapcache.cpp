@@ -0,0 +1,168 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "iconpixmapcache_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "kontactinterface_debug.h"
+
+#include <KConfig>
+#include <KConfigGroup>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QImage>
+#include <QPalette>
+#include <QPixmapCache>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+
+#include <chrono>
+
+using namespace KontactInterface;
+
+namespace
+{
+// Directories of themes not used for this long are removed
+constexpr auto maximumUnusedAge = std::chrono::days(30);
+// Touched whenever a session starts using a directory
+constexpr QLatin1StringView lastUsedMarker(".lastused");
+}
+
+IconPixmapCache::IconPixmapCache()
+{
+    mWriter.setMaxThreadCount(1);
+}
+
+IconPixmapCache *IconPixmapCache::self()
+{
+    static IconPixmapCache s_cache;
+    return &s_cache;
+}
+
+QPixmap IconPixmapCache::pixmap(const QString &name, int size, qreal devicePixelRatio)
+{
+    if (name.isEmpty()) {
+        return {};
+    }
+
+    const QString color = QGuiApplication::palette().color(QPalette::WindowText).name();
+    const QString key = u"kontact-icon:%1:%2:%3:%4@%5"_s.arg(QIcon::themeName(), color, name).arg(size).arg(devicePixelRatio);
+    QPixmap pm;
+    if (QPixmapCache::find(key, &pm)) {
+        return pm;
+    }
+
+    // Names can also be paths of icon files, those are not worth a copy
+    const QString directory = name.contains(u'/') ? QString() : themeDirectory();
+    const QString fileName = u"%1/%2-%3-%4@%5.png"_s.arg(directory, color.mid(1), name).arg(size).arg(devicePixelRatio);
+    if (!directory.isEmpty() && pm.load(fileName, "PNG")) {
+        pm.setDevicePixelRatio(devicePixelRatio);
+    } else {
+        const QIcon icon = QIcon::fromTheme(name);
+        if (icon.isNull()) {
+            return {};
+        }
+        pm = icon.pixmap(QSize(size, size), devicePixelRatio);
+        if (!directory.isEmpty() && !pm.isNull()) {
+            store(pm.toImage(), fileName);
+        }
+    }
+    QPixmapCache::insert(key, pm);
+    return pm;
+}
+
+void IconPixmapCache::store(const QImage &image, const QString &fileName)
+{
+    // Encoding is slow and the copy is only needed by the next session. A
+    // temporary file renamed into place is enough, a torn write cannot show up
+    // and losing an icon on a crash costs a render, so nothing is synced.
+    mWriter.start([image, fileName]() {
+        QTemporaryFile file(fileName + ".XXXXXX"_L1);
+        if (!file.open() || !image.save(&file, "PNG") || !file.rename(fileName)) {
+            qCDebug(KONTACTINTERFACE_LOG) << "Could not cache icon in" << fileName << file.errorString();
+        }
+    });
+}
+
+QString IconPixmapCache::themeDirectory()
+{
+    const QString themeName = QIcon::themeName();
+    if (themeName == mThemeName && !mThemeDirectory.isEmpty()) {
+        return mThemeDirectory;
+    }
+    mThemeName = themeName;
+    mThemeDirectory.clear();
+    if (themeName.isEmpty() || themeName.contains(u'/')) {
+        return {};
+    }
+
+    QDir cacheDir(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/kontact/icons"_L1);
+    const QString entry = themeName + u'-' + QString::number(themeStamp(themeName));
+    if (!cacheDir.mkpath(entry)) {
+        qCWarning(KONTACTINTERFACE_LOG) << "Could not create icon cache directory in" << cacheDir.path();
+        return {};
+    }
+    QFile marker(cacheDir.filePath(entry) + u'/' + lastUsedMarker);
+    if (!marker.open(QIODevice::WriteOnly) || !marker.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime)) {
+        qCDebug(KONTACTINTERFACE_LOG) << "Could not mark" << cacheDir.filePath(entry) << "as used" << marker.errorString();
+    }
+
+    // Other themes stay for switching back and forth, e.g. between a light and a
+    // dark variant, older stamps of this theme are outdated right away
+    const QDateTime oldestUse = QDateTime::currentDateTime().addDuration(-maximumUnusedAge);
+    const QStringList entries = cacheDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &other : entries) {
+        if (other == entry) {
+            continue;
+        }
+        const QString otherTheme = other.left(other.lastIndexOf(u'-'));
+        const QFileInfo otherMarker(cacheDir.filePath(other) + u'/' + lastUsedMarker);
+        if (otherTheme == themeName || !otherMarker.exists() || otherMarker.lastModified() < oldestUse) {
+            QDir(cacheDir.filePath(other)).removeRecursively();
+        }
+    }
+    mThemeDirectory = cacheDir.filePath(entry);
+    return mThemeDirectory;
+}
+
+qint64 IconPixmapCache::themeStamp(const QString &themeName)
+{
+    // Installing or updating a theme touches its index, which invalidates the
+    // pixmaps rendered from it. Icons may come from any inherited theme as well.
+    qint64 stamp = 0;
+    QStringList themes{themeName};
+    const QStringList searchPaths = QIcon::themeSearchPaths();
+    for (qsizetype i = 0; i < themes.size(); ++i) {
+        const QString theme = themes.at(i);
+        for (const QString &path : searchPaths) {
+            const QString indexFile = path + u'/' + theme + "/index.theme"_L1;
+            const QFileInfo index(indexFile);
+            if (!index.exists()) {
+                continue;
+            }
+            stamp = qMax(stamp, index.lastModified().toSecsSinceEpoch());
+            const KConfig config(indexFile, KConfig::SimpleConfig);
+            const QStringList inherits = config.group(u"Icon Theme"_s).readEntry("Inherits", QStringList());
+            for (const QString &parent : inherits) {
+                if (!themes.contains(parent)) {
+                    themes.append(parent);
+                }
+            }
+        }
+        // Every theme falls back to hicolor in the end
+        if (i == themes.size() - 1 && !themes.contains("hicolor"_L1)) {
+            themes.append(u"hicolor"_s);
+        }
+    }
+    return stamp;
+}
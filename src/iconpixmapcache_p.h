@@ -0,0 +1,52 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QPixmap>
+#include <QString>
+#include <QThreadPool>
+
+class QImage;
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Hands out rendered theme icons without looking them up in the theme and
+ * rendering them again each time.
+ *
+ * Pixmaps are kept in QPixmapCache and as PNG files below the cache location,
+ * so the next session does not render them either. Entries are keyed by icon
+ * name, size, device pixel ratio, icon theme and text color, the latter because
+ * monochrome icons follow the color scheme. The files live in a directory per
+ * theme, stamped with the installation time of the theme and of the themes it
+ * inherits from. Outdated directories of the current theme are removed, those
+ * of other themes once they were not used for a month. The files are written
+ * on a worker thread.
+ */
+class IconPixmapCache
+{
+public:
+    static IconPixmapCache *self();
+
+    [[nodiscard]] QPixmap pixmap(const QString &name, int size, qreal devicePixelRatio);
+
+private:
+    IconPixmapCache();
+
+    void store(const QImage &image, const QString &fileName);
+    [[nodiscard]] QString themeDirectory();
+    [[nodiscard]] static qint64 themeStamp(const QString &themeName);
+
+    QString mThemeName;
+    QString mThemeDirectory;
+    QThreadPool mWriter;
+};
+}
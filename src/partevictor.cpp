@@ -0,0 +1,164 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "partevictor_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "core_p.h"
+#include "kontactinterface_debug.h"
+#include "partpreloader_p.h"
+#include "plugin.h"
+#include "processmemory_p.h"
+#include "usagepredictor_p.h"
+
+#include <KSharedConfig>
+
+#include <QWidget>
+
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <malloc.h>
+#endif
+
+using namespace KontactInterface;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Parts are checked at least this often
+constexpr auto maximumCheckInterval = 60s;
+// Parts loaded or used more recently than this are kept even over the memory
+// budget when no idle timeout is set, so loading and unloading cannot loop
+constexpr auto minimumResidency = 60s;
+
+// Hands the pages freed by the deleted part back to the system, glibc keeps them otherwise
+void releaseFreedMemory()
+{
+#ifdef __GLIBC__
+    malloc_trim(0);
+#endif
+}
+}
+
+PartEvictor::PartEvictor(Core *core, CorePrivate *corePrivate)
+    : QObject(core)
+    , mCorePrivate(corePrivate)
+{
+    connect(&mTimer, &QTimer::timeout, this, &PartEvictor::check);
+}
+
+void PartEvictor::setLimits(std::chrono::milliseconds idleTimeout, qint64 memoryBudget)
+{
+    mIdleTimeout = idleTimeout;
+    mMemoryBudget = memoryBudget;
+    if (mIdleTimeout.count() <= 0 && mMemoryBudget <= 0) {
+        mTimer.stop();
+        return;
+    }
+
+    mTimer.start(mIdleTimeout.count() > 0 ? std::min<std::chrono::milliseconds>(mIdleTimeout, maximumCheckInterval) : maximumCheckInterval);
+    scheduleCheck();
+}
+
+void PartEvictor::scheduleCheck()
+{
+    if (mCheckScheduled || !mTimer.isActive()) {
+        return;
+    }
+    mCheckScheduled = true;
+    QTimer::singleShot(0, this, [this]() {
+        mCheckScheduled = false;
+        check();
+    });
+}
+
+KConfigGroup PartEvictor::stateGroup(const Plugin *plugin)
+{
+    const QString key = plugin->identifier().isEmpty() ? plugin->objectName() : plugin->identifier();
+    return KConfigGroup(KSharedConfig::openStateConfig(), "KontactUnloadedPart "_L1 + key);
+}
+
+bool PartEvictor::overMemoryBudget() const
+{
+    return mMemoryBudget > 0 && residentMemory() > mMemoryBudget;
+}
+
+void PartEvictor::check()
+{
+    // Least recently used first
+    QList<QPair<qint64, QByteArray>> candidates;
+    for (auto it = mCorePrivate->mParts.constBegin(); it != mCorePrivate->mParts.constEnd(); ++it) {
+        candidates.append({it->lastUsed.elapsed(), it.key()});
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    const auto residency = mIdleTimeout.count() > 0 ? mIdleTimeout : std::chrono::milliseconds(minimumResidency);
+    for (const auto &candidate : std::as_const(candidates)) {
+        // lastUsed restarts on load, a part that just came in stays for a while
+        if (candidate.first < residency.count()) {
+            continue;
+        }
+        const bool idle = mIdleTimeout.count() > 0 && candidate.first >= mIdleTimeout.count();
+        if (!idle && !overMemoryBudget()) {
+            continue;
+        }
+        if (evict(candidate.second)) {
+            releaseFreedMemory();
+        }
+    }
+
+    // Loading more ahead of time would only be unloaded again
+    const bool pressure = overMemoryBudget();
+    if (pressure && mCorePrivate->mPreloader && mCorePrivate->mPreloader->isActive()) {
+        qCDebug(KONTACTINTERFACE_LOG) << "Over the memory budget, stopping preloading";
+        mCorePrivate->mPreloader->stop();
+    }
+    mCorePrivate->mPredictor->setThrottled(pressure);
+}
+
+bool PartEvictor::evict(const QByteArray &libname)
+{
+    const CorePrivate::PartEntry entry = mCorePrivate->mParts.value(libname);
+    if (!entry.part) {
+        return false;
+    }
+    // Loaded by createPartAsync() but not claimed by Plugin::part() yet
+    if (entry.users.isEmpty()) {
+        return false;
+    }
+    if (entry.part->widget() && entry.part->widget()->isVisible()) {
+        return false;
+    }
+
+    // A shared part only goes away if all of its plugins agree
+    for (const Plugin *user : entry.users) {
+        if (user == mCorePrivate->mSelectedPlugin.data()) {
+            return false;
+        }
+        if (!user->queryClose()) {
+            qCDebug(KONTACTINTERFACE_LOG) << "Keeping part" << libname << "," << user->objectName() << "refuses to close";
+            return false;
+        }
+    }
+
+    qCDebug(KONTACTINTERFACE_LOG) << "Unloading part" << libname << "unused for" << entry.lastUsed.elapsed() << "ms";
+    for (Plugin *user : entry.users) {
+        KConfigGroup group = stateGroup(user);
+        user->saveProperties(group);
+        mCorePrivate->mUnloadedPlugins.insert(user);
+    }
+    // The plugins and the core forget the part through its destroyed() signal,
+    // Plugin::part() creates it again when needed
+    delete entry.part;
+    return true;
+}
+
+#include "moc_partevictor_p.cpp"
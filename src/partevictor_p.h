@@ -0,0 +1,68 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <KConfigGroup>
+
+#include <QObject>
+#include <QTimer>
+
+#include <chrono>
+
+namespace KontactInterface
+{
+class Core;
+class CorePrivate;
+class Plugin;
+
+/*!
+ * \internal
+ *
+ * Unloads parts that have not been used for a while, or the least recently
+ * used ones while the resident memory of the process is over a budget.
+ *
+ * Only parts created through Core::createPart() and claimed by a plugin are
+ * considered. A part is kept while it is shown, while it belongs to the
+ * selected plugin, while it was loaded or used within the idle timeout, or
+ * while any of the plugins sharing it refuses queryClose(). Preloading and
+ * prediction are held back while the process is over the memory budget. The plugins save their
+ * properties before the part goes away and read them back once Plugin::part()
+ * loaded it again.
+ */
+class PartEvictor : public QObject
+{
+    Q_OBJECT
+
+public:
+    PartEvictor(Core *core, CorePrivate *corePrivate);
+
+    void setLimits(std::chrono::milliseconds idleTimeout, qint64 memoryBudget);
+
+    /*!
+     * Checks the memory budget soon, e.g. after a part was loaded.
+     */
+    void scheduleCheck();
+
+    /*!
+     * Returns where \a plugin keeps its properties while its part is unloaded.
+     */
+    [[nodiscard]] static KConfigGroup stateGroup(const Plugin *plugin);
+
+private:
+    void check();
+    [[nodiscard]] bool evict(const QByteArray &libname);
+    [[nodiscard]] bool overMemoryBudget() const;
+
+    CorePrivate *const mCorePrivate;
+    QTimer mTimer;
+    std::chrono::milliseconds mIdleTimeout{0};
+    qint64 mMemoryBudget = 0;
+    bool mCheckScheduled = false;
+};
+}
@@ -0,0 +1,164 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "partpreloader_p.h"
+
+#include "core.h"
+#include "kontactinterface_debug.h"
+#include "plugin.h"
+#include "processmemory_p.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+
+#include <algorithm>
+
+using namespace KontactInterface;
+using namespace std::chrono_literals;
+
+namespace
+{
+// How long the user must not have touched mouse or keyboard before a part is loaded
+constexpr auto idleDelay = 3s;
+}
+
+PartPreloader::PartPreloader(Core *core)
+    : QObject(core)
+    , mCore(core)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout, this, &PartPreloader::loadNext);
+}
+
+PartPreloader::~PartPreloader()
+{
+    stop();
+}
+
+void PartPreloader::start(std::chrono::milliseconds timeBudget, qint64 memoryBudget)
+{
+    stop();
+
+    mTimeBudget = timeBudget;
+    mMemoryBudget = memoryBudget;
+    mTimeSpent = 0;
+    mInitialMemory = residentMemory();
+
+    QList<Plugin *> plugins = mCore->pluginList();
+    std::stable_sort(plugins.begin(), plugins.end(), [](const Plugin *lhs, const Plugin *rhs) {
+        return lhs->weight() < rhs->weight();
+    });
+    for (Plugin *plugin : std::as_const(plugins)) {
+        mQueue.append(plugin);
+    }
+
+    mActive = true;
+    QCoreApplication::instance()->installEventFilter(this);
+    mSinceLastInput.start();
+    scheduleNextStep();
+}
+
+void PartPreloader::stop()
+{
+    if (mActive) {
+        mActive = false;
+        QCoreApplication::instance()->removeEventFilter(this);
+    }
+    mTimer.stop();
+    mQueue.clear();
+}
+
+bool PartPreloader::isActive() const
+{
+    return mActive;
+}
+
+bool PartPreloader::eventFilter(QObject *watched, QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::KeyPress:
+    case QEvent::MouseButtonPress:
+    case QEvent::Wheel:
+    case QEvent::TouchBegin:
+        mSinceLastInput.start();
+        break;
+    default:
+        break;
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void PartPreloader::scheduleNextStep()
+{
+    if (mLoading) {
+        return;
+    }
+    if (mQueue.isEmpty()) {
+        if (mActive) {
+            qCDebug(KONTACTINTERFACE_LOG) << "Preloading finished";
+            stop();
+        }
+        return;
+    }
+    const auto idle = std::chrono::milliseconds(mSinceLastInput.elapsed());
+    mTimer.start(idle >= idleDelay ? 0ms : idleDelay - idle);
+}
+
+bool PartPreloader::budgetExceeded() const
+{
+    if (mTimeSpent >= mTimeBudget.count()) {
+        qCDebug(KONTACTINTERFACE_LOG) << "Preloading used up its time budget";
+        return true;
+    }
+    if (mMemoryBudget > 0 && mInitialMemory >= 0 && residentMemory() - mInitialMemory >= mMemoryBudget) {
+        qCDebug(KONTACTINTERFACE_LOG) << "Preloading used up its memory budget";
+        return true;
+    }
+    return false;
+}
+
+void PartPreloader::loadNext()
+{
+    // Yield to the user, input arrived while we were waiting
+    if (mSinceLastInput.elapsed() < std::chrono::milliseconds(idleDelay).count()) {
+        scheduleNextStep();
+        return;
+    }
+    if (budgetExceeded()) {
+        stop();
+        return;
+    }
+
+    while (!mQueue.isEmpty()) {
+        Plugin *plugin = mQueue.takeFirst();
+        if (!plugin || plugin->disabled() || plugin->isRunningStandalone()) {
+            continue;
+        }
+
+        qCDebug(KONTACTINTERFACE_LOG) << "Preloading part of" << plugin->objectName();
+        mLoading = true;
+        QElapsedTimer stepTimer;
+        stepTimer.start();
+        plugin->partAsync()
+            .then(this,
+                  [this, stepTimer](KParts::Part *) {
+                      mLoading = false;
+                      mTimeSpent += stepTimer.elapsed();
+                      scheduleNextStep();
+                  })
+            .onCanceled(this, [this]() {
+                mLoading = false;
+                scheduleNextStep();
+            });
+        return;
+    }
+
+    scheduleNextStep();
+}
+
+#include "moc_partpreloader_p.cpp"
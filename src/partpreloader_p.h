@@ -0,0 +1,65 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <chrono>
+
+namespace KontactInterface
+{
+class Core;
+class Plugin;
+
+/*!
+ * \internal
+ *
+ * Loads the parts of the plugins one at a time while the user is idle.
+ *
+ * Plugins are loaded in weight() order. Disabled plugins and plugins whose
+ * application runs standalone are skipped. Each step waits until there has
+ * been no user input for a while, and preloading stops once the time spent
+ * loading or the growth of the resident memory exceeds its budget.
+ */
+class PartPreloader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PartPreloader(Core *core);
+    ~PartPreloader() override;
+
+    void start(std::chrono::milliseconds timeBudget, qint64 memoryBudget);
+    void stop();
+    [[nodiscard]] bool isActive() const;
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void scheduleNextStep();
+    void loadNext();
+    [[nodiscard]] bool budgetExceeded() const;
+
+    Core *const mCore;
+    QList<QPointer<Plugin>> mQueue;
+    QTimer mTimer;
+    QElapsedTimer mSinceLastInput;
+    std::chrono::milliseconds mTimeBudget{0};
+    qint64 mMemoryBudget = 0;
+    qint64 mTimeSpent = 0;
+    qint64 mInitialMemory = -1;
+    bool mLoading = false;
+    bool mActive = false;
+};
+}
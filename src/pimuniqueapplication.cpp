@@ -9,6 +9,7 @@
 using namespace Qt::Literals::StringLiterals;
 
 #include "kontactinterface_debug.h"
+#include "tracing_p.h"
 
 #include <KAboutData>
 #include <KWindowSystem>
@@ -35,8 +36,10 @@ using namespace Qt::Literals::StringLiterals;
 #include <QMainWindow>
 #include <QWidget>
 
+#include <QDBusConnection>
 #include <QDBusConnectionInterface>
-#include <QDBusInterface>
+#include <QDBusMessage>
+#include <QDBusMetaType>
 
 using namespace KontactInterface;
 
@@ -137,6 +140,8 @@ void PimUniqueApplication::setAboutData(KAboutData &aboutData)
 {
     KAboutData::setApplicationData(aboutData);
     aboutData.setupCommandLine(d->cmdArgs);
+    // For newInstances()
+    qDBusRegisterMetaType<QList<QStringList>>();
     // This object name is used in start(), and also in kontact's UniqueAppHandler.
     const QString objectName = u'/' + QApplication::applicationName() + "_PimApplication"_L1;
     QDBusConnection::sessionBus().registerObject(objectName,
@@ -145,17 +150,97 @@ void PimUniqueApplication::setAboutData(KAboutData &aboutData)
                                                      | QDBusConnection::ExportAdaptors);
 }
 
-static bool callNewInstance(const QString &appName, const QString &serviceName, const QByteArray &asn_id, const QStringList &arguments)
+namespace
+{
+enum class ForwardResult {
+    Forwarded,
+    NotRunning,
+    // The running instance does not know the method, e.g. newInstances() of an older version
+    Unsupported,
+    Failed,
+};
+
+int s_startTimeout = 5000;
+}
+
+static ForwardResult callRunningInstance(const QString &appName, const QString &method, const QVariantList &arguments)
 {
+    // A plain method call: no introspection round trip as with QDBusInterface,
+    // and no separate check whether the name is registered, the bus daemon
+    // reports a missing owner as the reply to this very call.
+    const QString serviceName = "org.kde."_L1 + appName;
     const QString objectName = u'/' + appName + "_PimApplication"_L1;
-    QDBusInterface iface(serviceName, objectName, u"org.kde.PIMUniqueApplication"_s, QDBusConnection::sessionBus());
-    if (iface.isValid()) {
-        QDBusReply<int> reply = iface.call(u"newInstance"_s, asn_id, arguments, QDir::currentPath());
-        if (reply.isValid()) {
-            return true;
+    QDBusMessage message = QDBusMessage::createMethodCall(serviceName, objectName, u"org.kde.PIMUniqueApplication"_s, method);
+    message.setArguments(arguments);
+    // We start the application ourselves if nobody owns the name
+    message.setAutoStartService(false);
+
+    const QDBusMessage reply = QDBusConnection::sessionBus().call(message, QDBus::Block, s_startTimeout);
+    if (reply.type() == QDBusMessage::ReplyMessage) {
+        return ForwardResult::Forwarded;
+    }
+
+    const QString error = reply.errorName();
+    if (error == "org.freedesktop.DBus.Error.NameHasNoOwner"_L1 || error == "org.freedesktop.DBus.Error.ServiceUnknown"_L1) {
+        return ForwardResult::NotRunning;
+    }
+    if (error == "org.freedesktop.DBus.Error.NoReply"_L1) {
+        // A busy instance still gets the call and starting a second one would be wrong,
+        // but the owner may also have died before answering
+        if (QDBusConnection::sessionBus().interface()->isServiceRegistered(serviceName)) {
+            qCDebug(KONTACTINTERFACE_LOG) << "no reply from" << serviceName << "within" << s_startTimeout << "ms, assuming it handles the arguments";
+            return ForwardResult::Forwarded;
+        }
+        qCDebug(KONTACTINTERFACE_LOG) << serviceName << "went away without replying";
+        return ForwardResult::NotRunning;
+    }
+    if (error == "org.freedesktop.DBus.Error.UnknownMethod"_L1) {
+        return ForwardResult::Unsupported;
+    }
+    qCWarning(KONTACTINTERFACE_LOG) << "error forwarding arguments to" << serviceName << ":" << reply.errorMessage();
+    return ForwardResult::Failed;
+}
+
+static ForwardResult callNewInstance(const QString &appName, const QByteArray &asn_id, const QStringList &arguments)
+{
+    return callRunningInstance(appName, u"newInstance"_s, {asn_id, arguments, QDir::currentPath()});
+}
+
+static ForwardResult callNewInstances(const QString &appName, const QByteArray &asn_id, const QList<QStringList> &argumentLists)
+{
+    qDBusRegisterMetaType<QList<QStringList>>();
+    const ForwardResult result =
+        callRunningInstance(appName, u"newInstances"_s, {asn_id, QVariant::fromValue(argumentLists), QDir::currentPath()});
+    if (result != ForwardResult::Unsupported) {
+        return result;
+    }
+
+    // One call per request then
+    for (const QStringList &arguments : argumentLists) {
+        const ForwardResult single = callNewInstance(appName, asn_id, arguments);
+        if (single != ForwardResult::Forwarded) {
+            return single;
         }
     }
-    return false;
+    return ForwardResult::Forwarded;
+}
+
+static QByteArray startupIdForForwarding()
+{
+    QByteArray new_asn_id;
+    if (KWindowSystem::isPlatformX11()) {
+#if KONTACTINTERFACE_HAVE_X11
+        new_asn_id = QX11Info::nextStartupId();
+#endif
+    } else if (KWindowSystem::isPlatformWayland()) {
+        new_asn_id = qgetenv("XDG_ACTIVATION_TOKEN");
+    }
+    return new_asn_id;
+}
+
+void PimUniqueApplication::setStartTimeout(int timeout)
+{
+    s_startTimeout = timeout;
 }
 
 int PimUniqueApplication::newInstance()
@@ -166,25 +251,18 @@ int PimUniqueApplication::newInstance()
 bool PimUniqueApplication::start(const QStringList &arguments)
 {
     const QString appName = QApplication::applicationName();
+    TraceSpan span("PimUniqueApplication::start");
+    if (span.isActive()) {
+        span.setDetail(appName);
+    }
 
     // Try talking to /appName_PimApplication in org.kde.appName,
     // (which could be kontact or the standalone application),
     // otherwise the current app being started will register to DBus.
 
     const QString serviceName = "org.kde."_L1 + appName;
-    if (QDBusConnection::sessionBus().interface()->isServiceRegistered(serviceName)) {
-        QByteArray new_asn_id;
-        if (KWindowSystem::isPlatformX11()) {
-#if KONTACTINTERFACE_HAVE_X11
-            new_asn_id = QX11Info::nextStartupId();
-#endif
-        } else if (KWindowSystem::isPlatformWayland()) {
-            new_asn_id = qgetenv("XDG_ACTIVATION_TOKEN");
-        }
-
-        if (callNewInstance(appName, serviceName, new_asn_id, arguments)) {
-            return false; // success means that main() can exit now.
-        }
+    if (callNewInstance(appName, startupIdForForwarding(), arguments) == ForwardResult::Forwarded) {
+        return false; // success means that main() can exit now.
     }
 
     qCDebug(KONTACTINTERFACE_LOG) << "kontact not running -- start standalone application";
@@ -198,6 +276,35 @@ bool PimUniqueApplication::start(const QStringList &arguments)
     return true;
 }
 
+bool PimUniqueApplication::start(const QList<QStringList> &argumentLists)
+{
+    if (argumentLists.isEmpty()) {
+        return start(QStringList{QApplication::applicationName()});
+    }
+
+    const QString appName = QApplication::applicationName();
+    TraceSpan span("PimUniqueApplication::start batch");
+    if (span.isActive()) {
+        span.setDetail(appName);
+    }
+
+    if (callNewInstances(appName, startupIdForForwarding(), argumentLists) == ForwardResult::Forwarded) {
+        return false;
+    }
+
+    qCDebug(KONTACTINTERFACE_LOG) << "kontact not running -- start standalone application";
+
+    QDBusConnection::sessionBus().registerService("org.kde."_L1 + appName);
+
+    PimUniqueApplicationPrivate::disableChromiumCrashHandler();
+
+    auto app = static_cast<PimUniqueApplication *>(qApp);
+    for (const QStringList &arguments : argumentLists) {
+        app->activate(arguments, QDir::currentPath());
+    }
+    return true;
+}
+
 // This is called via DBus either by another instance that has just been
 // started or by Kontact when the module is activated
 int PimUniqueApplication::newInstance(const QByteArray &startupId, const QStringList &arguments, const QString &workingDirectory)
@@ -225,6 +332,19 @@ int PimUniqueApplication::newInstance(const QByteArray &startupId, const QString
     return 0;
 }
 
+int PimUniqueApplication::newInstances(const QByteArray &startupId, const QList<QStringList> &argumentLists, const QString &workingDirectory)
+{
+    if (argumentLists.isEmpty()) {
+        return 0;
+    }
+    // The first request raises the window, the others only get their arguments handled
+    const int result = newInstance(startupId, argumentLists.constFirst(), workingDirectory);
+    for (qsizetype i = 1; i < argumentLists.size(); ++i) {
+        activate(argumentLists.at(i), workingDirectory);
+    }
+    return result;
+}
+
 int PimUniqueApplication::activate(const QStringList &arguments, const QString &workingDirectory)
 {
     Q_UNUSED(arguments)
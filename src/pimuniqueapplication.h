@@ -47,10 +47,32 @@ public:
     /*!
      * Register this process as a unique application, if not already running.
      * Typically called in main().
+     * If an instance is running already, the arguments are forwarded to it with
+     * a single D-Bus call and false is returned.
      * \a arguments should start with the appname, as QCoreApplication::arguments() does.
      */
     static bool start(const QStringList &arguments);
 
+    /*!
+     * Like start(), but for several requests at once, e.g. files to open that
+     * were collected by the caller.
+     *
+     * All \a argumentLists are forwarded to a running instance with a single
+     * newInstances() call, so its window is activated once for the batch.
+     * Instances without newInstances() get one newInstance() call per request.
+     * \since 6.8
+     */
+    static bool start(const QList<QStringList> &argumentLists);
+
+    /*!
+     * Sets the \a timeout in milliseconds start() waits for an already running
+     * instance to accept the arguments. If it does not answer in time, it is
+     * assumed to be busy handling them, and start() still returns false.
+     * The default is 5000 milliseconds.
+     * \since 6.8
+     */
+    static void setStartTimeout(int timeout);
+
     /*!
      *
      */
@@ -60,6 +82,13 @@ public Q_SLOTS:
     Q_SCRIPTABLE int newInstance();
     Q_SCRIPTABLE virtual int newInstance(const QByteArray &startupId, const QStringList &arguments, const QString &workingDirectory);
 
+    /*!
+     * Handles several requests at once: the window is raised for the first of
+     * \a argumentLists only, the others just get activate() called.
+     * \since 6.8
+     */
+    Q_SCRIPTABLE int newInstances(const QByteArray &startupId, const QList<QStringList> &argumentLists, const QString &workingDirectory);
+
 protected:
     virtual int activate(const QStringList &arguments, const QString &workingDirectory);
 
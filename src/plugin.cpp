@@ -11,20 +11,48 @@
 using namespace Qt::Literals::StringLiterals;
 
 #include "core.h"
+#include "core_p.h"
+#include "iconpixmapcache_p.h"
 #include "kontactinterface_debug.h"
 #include "processes.h"
+#include "servicenameregistrar_p.h"
+#include "tracing_p.h"
 
 #include <KAboutData>
 #include <KIO/CommandLauncherJob>
+#include <KWindowSystem>
 #include <KXMLGUIFactory>
 
+#include "config-kontactinterface.h"
+#if KONTACTINTERFACE_HAVE_X11
+#include <KStartupInfo>
+#include <private/qtx11extras_p.h>
+#endif
+
+#if __has_include(<KWaylandExtras>)
+#include <KWaylandExtras>
+#define HAVE_WAYLAND
+#endif
+
+#include <QBuffer>
+#include <QCryptographicHash>
 #include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QDBusMessage>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 #include <QDir>
 #include <QDomDocument>
 #include <QFileInfo>
+#include <QSaveFile>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
 
 #include <QCoreApplication>
+#include <QPromise>
 #include <QStandardPaths>
+#include <QTimer>
+#include <QWindow>
 
 using namespace KontactInterface;
 
@@ -39,6 +67,11 @@ public:
     void partDestroyed();
     void setXmlFiles();
     void removeInvisibleToolbarActions(Plugin *plugin);
+    void activateStandalone(Plugin *plugin);
+    void forwardToStandalone(Plugin *plugin, const QByteArray &startupId);
+    void launchExecutable();
+    void attachGuiClient(Plugin *plugin);
+    [[nodiscard]] QString clientServiceName(const Plugin *plugin);
 
     Core *core = nullptr;
     QList<QAction *> newActions;
@@ -53,6 +86,8 @@ public:
     KParts::Part *part = nullptr;
     bool hasPart = true;
     bool disabled = false;
+    // Set while the GUI client waits for the plugin to be used to join the factory
+    bool guiClientPending = false;
 };
 //@endcond
 Plugin::Plugin(Core *core, QObject *parent, const KPluginMetaData &, const char *appName, const char *pluginName)
@@ -61,7 +96,11 @@ Plugin::Plugin(Core *core, QObject *parent, const KPluginMetaData &, const char
     , d(new PluginPrivate)
 {
     setObjectName(QLatin1StringView(appName));
-    core->factory()->addClient(this);
+    if (core->d->mGuiClientsDeferred) {
+        d->guiClientPending = true;
+    } else {
+        core->d->addGuiClient(this);
+    }
 
     d->pluginName = pluginName ? pluginName : appName;
     d->core = core;
@@ -102,6 +141,11 @@ QString Plugin::icon() const
     return d->icon;
 }
 
+QPixmap Plugin::iconPixmap(int size, qreal devicePixelRatio) const
+{
+    return IconPixmapCache::self()->pixmap(d->icon, size, devicePixelRatio);
+}
+
 void Plugin::setExecutableName(const QString &bin)
 {
     d->executableName = bin;
@@ -135,29 +179,66 @@ const KAboutData Plugin::aboutData()
 KParts::Part *Plugin::part()
 {
     if (!d->part) {
+        const TraceSpan span("Plugin::part", d->pluginName.constData());
         d->part = createPart();
         if (d->part) {
+            d->attachGuiClient(this);
             connect(d->part, &KParts::Part::destroyed, this, [this]() {
                 d->partDestroyed();
             });
             d->removeInvisibleToolbarActions(this);
+            core()->d->registerPartUser(this, d->part);
             core()->partLoaded(this, d->part);
         }
     }
     return d->part;
 }
 
-QString Plugin::registerClient()
+QFuture<KParts::Part *> Plugin::partAsync()
+{
+    if (d->part) {
+        return QtFuture::makeReadyValueFuture(d->part);
+    }
+
+    if (d->partLibraryName.isEmpty()) {
+        auto promise = std::make_shared<QPromise<KParts::Part *>>();
+        promise->start();
+        QTimer::singleShot(0, this, [this, promise]() {
+            promise->addResult(part());
+            promise->finish();
+        });
+        return promise->future();
+    }
+
+    return core()->createPartAsync(d->partLibraryName.constData()).then(this, [this](KParts::Part *) {
+        // The part is in the core's cache now, createPart() picks it up from there
+        return part();
+    });
+}
+
+QString Plugin::PluginPrivate::clientServiceName(const Plugin *plugin)
 {
-    if (d->serviceName.isEmpty()) {
-        d->serviceName = "org.kde."_L1 + QLatin1StringView(objectName().toLatin1());
+    if (serviceName.isEmpty()) {
+        serviceName = "org.kde."_L1 + QLatin1StringView(plugin->objectName().toLatin1());
 #ifdef Q_OS_WIN
         const QString pid = QString::number(QCoreApplication::applicationPid());
-        d->serviceName.append(".unique-"_L1 + pid);
+        serviceName.append(".unique-"_L1 + pid);
 #endif
-        QDBusConnection::sessionBus().registerService(d->serviceName);
     }
-    return d->serviceName;
+    return serviceName;
+}
+
+QString Plugin::registerClient()
+{
+    // Also waits for a request registerClientAsync() started
+    const QString name = d->clientServiceName(this);
+    ServiceNameRegistrar::self()->registerServiceNow(name);
+    return name;
+}
+
+QFuture<bool> Plugin::registerClientAsync()
+{
+    return ServiceNameRegistrar::self()->registerService(d->clientServiceName(this));
 }
 
 int Plugin::weight() const
@@ -215,10 +296,13 @@ Core *Plugin::core() const
 
 void Plugin::aboutToSelect()
 {
+    d->attachGuiClient(this);
+
     // Because the 3 korganizer plugins share the same part, we need to switch
     // that part's XML files every time we are about to show its GUI...
     d->setXmlFiles();
 
+    d->core->d->pluginSelected(this);
     select();
 }
 
@@ -236,11 +320,174 @@ void Plugin::PluginPrivate::partDestroyed()
     part = nullptr;
 }
 
+void Plugin::PluginPrivate::activateStandalone(Plugin *plugin)
+{
+    // The running application may only raise its window with an activation
+    // token of ours, which the compositor hands out asynchronously
+#ifdef HAVE_WAYLAND
+    QWindow *window = core->windowHandle();
+    if (KWindowSystem::isPlatformWayland() && window) {
+        const quint32 serial = KWaylandExtras::lastInputSerial(window);
+        auto context = new QObject(plugin);
+        QObject::connect(KWaylandExtras::self(),
+                         &KWaylandExtras::xdgActivationTokenArrived,
+                         context,
+                         [this, plugin, context, serial](int tokenSerial, const QString &token) {
+                             if (quint32(tokenSerial) != serial) {
+                                 return;
+                             }
+                             context->deleteLater();
+                             forwardToStandalone(plugin, token.toUtf8());
+                         });
+        KWaylandExtras::requestXdgActivationToken(window, serial, executableName);
+        return;
+    }
+#endif
+
+    QByteArray startupId;
+#if KONTACTINTERFACE_HAVE_X11
+    if (KWindowSystem::isPlatformX11()) {
+        startupId = KStartupInfo::createNewStartupIdForTimestamp(QX11Info::appUserTime());
+    }
+#endif
+    forwardToStandalone(plugin, startupId);
+}
+
+void Plugin::PluginPrivate::forwardToStandalone(Plugin *plugin, const QByteArray &startupId)
+{
+    const QString appName = plugin->objectName();
+    const QString objectPath = u'/' + appName + "_PimApplication"_L1;
+    QDBusConnection bus = QDBusConnection::sessionBus();
+    // While the application is not running standalone, we own its name ourselves
+    if (bus.objectRegisteredAt(objectPath)) {
+        launchExecutable();
+        return;
+    }
+
+    // Asking the running application directly saves starting a process that
+    // would only forward its arguments to it over the bus
+    QDBusMessage message = QDBusMessage::createMethodCall("org.kde."_L1 + appName, objectPath, u"org.kde.PIMUniqueApplication"_s, u"newInstance"_s);
+    message << startupId << QStringList{executableName} << QDir::currentPath();
+    message.setAutoStartService(false);
+
+    auto watcher = new QDBusPendingCallWatcher(bus.asyncCall(message), plugin);
+    QObject::connect(watcher, &QDBusPendingCallWatcher::finished, plugin, [this, appName](QDBusPendingCallWatcher *call) {
+        call->deleteLater();
+        const QDBusPendingReply<int> reply = *call;
+        if (!reply.isError()) {
+            return;
+        }
+        const QString error = reply.error().name();
+        if (error == "org.freedesktop.DBus.Error.NoReply"_L1) {
+            // Busy, but the call arrived; a second instance would only help if it died meanwhile
+            QDBusConnection bus = QDBusConnection::sessionBus();
+            auto ownerWatcher = new QDBusPendingCallWatcher(bus.interface()->asyncCall(u"NameHasOwner"_s, "org.kde."_L1 + appName), call->parent());
+            QObject::connect(ownerWatcher, &QDBusPendingCallWatcher::finished, call->parent(), [this, appName](QDBusPendingCallWatcher *ownerCall) {
+                ownerCall->deleteLater();
+                const QDBusPendingReply<bool> hasOwner = *ownerCall;
+                if (hasOwner.isError() || !hasOwner.value()) {
+                    qCDebug(KONTACTINTERFACE_LOG) << appName << "went away without replying";
+                    launchExecutable();
+                    return;
+                }
+                qCDebug(KONTACTINTERFACE_LOG) << "no reply from" << appName << ", assuming it got activated";
+            });
+            return;
+        }
+        qCDebug(KONTACTINTERFACE_LOG) << "could not activate" << appName << "over D-Bus:" << error;
+        launchExecutable();
+    });
+}
+
+void Plugin::PluginPrivate::attachGuiClient(Plugin *plugin)
+{
+    if (!guiClientPending) {
+        return;
+    }
+    guiClientPending = false;
+    const TraceSpan span("Plugin::attachGuiClient", pluginName.constData());
+    core->d->addGuiClient(plugin);
+}
+
+void Plugin::PluginPrivate::launchExecutable()
+{
+    auto job = new KIO::CommandLauncherJob(executableName);
+    job->start();
+}
+
+// Copies the GUI description from \a reader to \a device, leaving out the
+// \a hideActions of the toolbars. Counts the elements of the source in
+// \a elementCount and returns its version in \a version.
+static bool writeFilteredGuiDescription(QXmlStreamReader &reader, QIODevice *device, const QStringList &hideActions, int &elementCount, QString &version)
+{
+    QXmlStreamWriter writer(device);
+    int depth = 0;
+    bool inToolBar = false;
+    while (!reader.atEnd()) {
+        reader.readNext();
+        if (reader.isStartElement()) {
+            ++depth;
+            ++elementCount;
+            if (depth == 1) {
+                version = reader.attributes().value("version"_L1).toString();
+            } else if (depth == 2) {
+                // 1. Containers are the children of the root element
+                inToolBar = reader.name().compare("ToolBar"_L1, Qt::CaseInsensitive) == 0;
+            } else if (depth == 3 && inToolBar && reader.name().compare("Action"_L1, Qt::CaseInsensitive) == 0) {
+                // 2. Actions in toolbars
+                if (hideActions.contains(reader.attributes().value("name"_L1))) {
+                    reader.skipCurrentElement();
+                    --depth;
+                    continue;
+                }
+            }
+        } else if (reader.isEndElement()) {
+            --depth;
+        }
+        writer.writeCurrentToken(reader);
+    }
+    if (reader.hasError()) {
+        qCWarning(KONTACTINTERFACE_LOG) << "error parsing GUI description:" << reader.errorString();
+        return false;
+    }
+    return true;
+}
+
+static int countElements(const QDomElement &element)
+{
+    int count = 1;
+    for (QDomElement child = element.firstChildElement(); !child.isNull(); child = child.nextSiblingElement()) {
+        count += countElements(child);
+    }
+    return count;
+}
+
+// Finds the file the GUI description of \a client was read from, the same way
+// KXMLGUIClient::setXMLFile() looks up relative file names.
+static QString locateGuiDescription(const KXMLGUIClient *client)
+{
+    const QString xmlFile = client->xmlFile();
+    if (xmlFile.isEmpty()) {
+        return {};
+    }
+    if (!QDir::isRelativePath(xmlFile)) {
+        return QFileInfo(xmlFile).isFile() ? xmlFile : QString();
+    }
+    const QString relativeFile = "kxmlgui5/"_L1 + client->componentName() + u'/' + xmlFile;
+    const QString file = QStandardPaths::locate(QStandardPaths::GenericDataLocation, relativeFile);
+    if (!file.isEmpty()) {
+        return file;
+    }
+    const QString resource = ":/"_L1 + relativeFile;
+    return QFileInfo(resource).isFile() ? resource : QString();
+}
+
 void Plugin::PluginPrivate::removeInvisibleToolbarActions(Plugin *plugin)
 {
     if (pluginName.isEmpty()) {
         return;
     }
+    const TraceSpan span("Plugin::removeInvisibleToolbarActions", pluginName.constData());
 
     // Hide unwanted toolbar action by modifying the XML before createGUI, rather
     // than doing it by calling removeAction on the toolbar after createGUI. Both
@@ -248,45 +495,78 @@ void Plugin::PluginPrivate::removeInvisibleToolbarActions(Plugin *plugin)
     // actions don't appear in "edit toolbars". #207296
     const QStringList hideActions = plugin->invisibleToolbarActions();
     // qCDebug(KONTACTINTERFACE_LOG) << "Hiding actions" << hideActions << "from" << pluginName << part;
+
+    const QString newAppFile =
+        QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kontact/default-"_L1 + QLatin1StringView(pluginName) + ".rc"_L1;
+    const QString stampFile = newAppFile + ".stamp"_L1;
+
+    // The generated file only depends on the GUI description of the part and on
+    // the actions to hide, so it is only rewritten when one of them changed.
+    // The description is identified without serializing the DOM.
     const QDomDocument doc = part->domDocument();
-    const QDomElement docElem = doc.documentElement();
-    // 1. Iterate over containers
-    for (QDomElement containerElem = docElem.firstChildElement(); !containerElem.isNull(); containerElem = containerElem.nextSiblingElement()) {
-        if (QString::compare(containerElem.tagName(), "ToolBar"_L1, Qt::CaseInsensitive) == 0) {
-            // 2. Iterate over actions in toolbars
-            QDomElement actionElem = containerElem.firstChildElement();
-            while (!actionElem.isNull()) {
-                QDomElement nextActionElem = actionElem.nextSiblingElement();
-                if (QString::compare(actionElem.tagName(), "Action"_L1, Qt::CaseInsensitive) == 0) {
-                    // qCDebug(KONTACTINTERFACE_LOG) << "Looking at action" << actionElem.attribute("name");
-                    if (hideActions.contains(actionElem.attribute(u"name"_s))) {
-                        // qCDebug(KONTACTINTERFACE_LOG) << "REMOVING";
-                        containerElem.removeChild(actionElem);
-                    }
-                }
-                actionElem = nextActionElem;
-            }
-        }
+    const QString version = doc.documentElement().attribute(u"version"_s);
+    const QString sourceFile = locateGuiDescription(part);
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(part->componentName().toUtf8());
+    hash.addData(part->xmlFile().toUtf8());
+    hash.addData(version.toUtf8());
+    if (!sourceFile.isEmpty()) {
+        const QFileInfo sourceInfo(sourceFile);
+        hash.addData(QFile::encodeName(sourceFile));
+        hash.addData(QByteArray::number(sourceInfo.size()));
+        hash.addData(QByteArray::number(sourceInfo.lastModified().toMSecsSinceEpoch()));
     }
+    hash.addData(hideActions.join(u'\n').toUtf8());
+    const QByteArray stamp = hash.result().toHex();
 
-    // Possible optimization: we could do all the above and the writing below
-    // only when (newAppFile does not exist) or (version of domDocument > version of newAppFile)  (*)
-    // This requires parsing newAppFile when it exists, though, and better use
-    // the fast kdeui code for that rather than a full QDomDocument.
-    // (*) or when invisibleToolbarActions() changes :)
+    QFile stampReader(stampFile);
+    if (QFileInfo::exists(newAppFile) && stampReader.open(QFile::ReadOnly) && stampReader.readAll().trimmed() == stamp) {
+        setXmlFiles();
+        return;
+    }
+    stampReader.close();
+
+    QByteArray output;
+    bool filtered = false;
+    if (!sourceFile.isEmpty()) {
+        // Streaming from the file is only right if the part did not merge
+        // other XML into its DOM, or loaded a different version of the file
+        QFile sourceReader(sourceFile);
+        if (sourceReader.open(QFile::ReadOnly)) {
+            QBuffer buffer(&output);
+            buffer.open(QIODevice::WriteOnly);
+            QXmlStreamReader reader(&sourceReader);
+            int elementCount = 0;
+            QString sourceVersion;
+            filtered = writeFilteredGuiDescription(reader, &buffer, hideActions, elementCount, sourceVersion) && sourceVersion == version
+                && elementCount == countElements(doc.documentElement());
+        }
+    }
+    if (!filtered) {
+        output.clear();
+        QBuffer buffer(&output);
+        buffer.open(QIODevice::WriteOnly);
+        QXmlStreamReader reader(doc.toByteArray());
+        int elementCount = 0;
+        QString sourceVersion;
+        filtered = writeFilteredGuiDescription(reader, &buffer, hideActions, elementCount, sourceVersion);
+    }
 
-    const QString newAppFile =
-        QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kontact/default-"_L1 + QLatin1StringView(pluginName) + ".rc"_L1;
     const QFileInfo fileInfo(newAppFile);
     QDir().mkpath(fileInfo.absolutePath());
 
-    QFile file(newAppFile);
-    if (!file.open(QFile::WriteOnly)) {
+    QSaveFile file(newAppFile);
+    if (!filtered || !file.open(QFile::WriteOnly) || file.write(output) != output.size() || !file.commit()) {
         qCWarning(KONTACTINTERFACE_LOG) << "error writing to" << newAppFile;
+        QFile::remove(stampFile);
         return;
     }
-    file.write(doc.toString().toUtf8());
-    file.flush();
+
+    QSaveFile stampWriter(stampFile);
+    if (stampWriter.open(QFile::WriteOnly)) {
+        stampWriter.write(stamp);
+        stampWriter.commit();
+    }
 
     setXmlFiles();
 }
@@ -296,13 +576,14 @@ void Plugin::PluginPrivate::setXmlFiles()
     if (pluginName.isEmpty()) {
         return;
     }
+    const TraceSpan span("Plugin::setXmlFiles", pluginName.constData());
     const QString newAppFile =
         QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kontact/default-"_L1 + QLatin1StringView(pluginName) + ".rc"_L1;
     const QString localFile =
         QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation) + "/kontact/local-"_L1 + QLatin1StringView(pluginName) + ".rc"_L1;
     if (!localFile.isEmpty() && !newAppFile.isEmpty()) {
         if (part->xmlFile() != newAppFile || part->localXMLFile() != localFile) {
-            part->replaceXMLFile(newAppFile, localFile);
+            core->d->replaceXmlFile(part, newAppFile, localFile);
         }
     }
 }
@@ -321,8 +602,7 @@ void Plugin::bringToForeground()
 #ifdef Q_OS_WIN
     activateWindowForProcess(d->executableName);
 #else
-    auto job = new KIO::CommandLauncherJob(d->executableName);
-    job->start();
+    d->activateStandalone(this);
 #endif
 }
 
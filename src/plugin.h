@@ -15,8 +15,10 @@
 #include <KPluginFactory>
 #include <KXMLGUIClient>
 
+#include <QFuture>
 #include <QList>
 #include <QObject>
+#include <QPixmap>
 #include <QStringList>
 
 class KAboutData;
@@ -117,6 +119,17 @@ public:
      */
     [[nodiscard]] QString icon() const;
 
+    /*!
+     * Returns the icon of the plugin rendered at \a size logical pixels for
+     * the \a devicePixelRatio.
+     *
+     * The rendering is shared within the process and kept across sessions,
+     * use this rather than QIcon::fromTheme(icon()) where the icon is shown
+     * often, e.g. in the side bar.
+     * \since 6.8
+     */
+    [[nodiscard]] QPixmap iconPixmap(int size, qreal devicePixelRatio) const;
+
     /*!
      * Sets the \a name of executable (if existent).
      */
@@ -159,6 +172,17 @@ public:
      */
     [[nodiscard]] KParts::Part *part();
 
+    /*!
+     * Non-blocking variant of part().
+     *
+     * If the part is not loaded yet, the library set with setPartLibraryName()
+     * is loaded in the background and part() is called once it is available,
+     * so the future finishes with the same pointer part() returns. Plugins
+     * without a part library name get their part created from the event loop.
+     * \since 6.8
+     */
+    [[nodiscard]] QFuture<KParts::Part *> partAsync();
+
     /*!
      * This function is called when the plugin is selected by the user before the
      * widget of the KPart belonging to the plugin is raised.
@@ -207,9 +231,21 @@ public:
 
     /*!
      * Registers the client at DBus and returns the dbus identifier.
+     *
+     * This waits for the bus daemon to grant the name, see
+     * registerClientAsync() for carrying on meanwhile.
      */
     QString registerClient();
 
+    /*!
+     * Registers the client at DBus like registerClient(), without waiting for
+     * the bus. The returned future finishes once the registration did, its
+     * result tells whether the name is owned now. Until then calls to the name,
+     * e.g. from a second start of the standalone application, find nobody.
+     * \since 6.8
+     */
+    [[nodiscard]] QFuture<bool> registerClientAsync();
+
     /*!
      * Return the weight of the plugin. The higher the weight the lower it will
      * be displayed in the sidebar. The default implementation returns 0.
@@ -0,0 +1,224 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "pluginmetadatacache_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "kontactinterface_debug.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QThreadPool>
+#include <QTimer>
+
+using namespace KontactInterface;
+
+namespace
+{
+// Bump whenever the layout of the cache file changes
+constexpr int cacheFormatVersion = 2;
+
+// Coalesces the insertions of a session start into a single write
+constexpr int saveDelay = 10000;
+}
+
+PluginMetaDataCache *PluginMetaDataCache::self()
+{
+    static PluginMetaDataCache s_cache;
+    return &s_cache;
+}
+
+PluginMetaDataCache::PluginMetaDataCache()
+    : mCacheFile(QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation) + "/kontact/partmetadata.json"_L1)
+{
+    load();
+    qAddPostRoutine(&PluginMetaDataCache::saveAtExit);
+}
+
+bool PluginMetaDataCache::lookup(const QByteArray &libname, KPluginMetaData &metaData, QString &errorString)
+{
+    QMutexLocker locker(&mMutex);
+    const auto it = mEntries.constFind(libname);
+    if (it == mEntries.constEnd()) {
+        return false;
+    }
+    if (!it->fileName.isEmpty() && !isUpToDate(libname, *it)) {
+        qCDebug(KONTACTINTERFACE_LOG) << "Plugin" << it->fileName << "or its search paths changed, dropping cached metadata";
+        mEntries.erase(it);
+        mDirty = true;
+        return false;
+    }
+
+    if (!it->errorString.isEmpty()) {
+        errorString = it->errorString;
+    } else {
+        metaData = KPluginMetaData(it->metaData, it->fileName);
+    }
+    return true;
+}
+
+void PluginMetaDataCache::insert(const QByteArray &libname, const KPluginMetaData &metaData)
+{
+    if (!metaData.isValid() || metaData.isStaticPlugin() || metaData.fileName().isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&mMutex);
+    Entry entry;
+    entry.fileName = metaData.fileName();
+    entry.metaData = metaData.rawData();
+    stamp(libname, entry);
+    mEntries.insert(libname, entry);
+    mDirty = true;
+    scheduleSave();
+}
+
+void PluginMetaDataCache::insertFailure(const QByteArray &libname, const QString &fileName, const QString &errorString)
+{
+    // Not written to disk, a failure may well be gone after the next update
+    QMutexLocker locker(&mMutex);
+    Entry entry;
+    entry.fileName = fileName;
+    entry.errorString = errorString;
+    if (!fileName.isEmpty()) {
+        stamp(libname, entry);
+    }
+    mEntries.insert(libname, entry);
+}
+
+bool PluginMetaDataCache::isUpToDate(const QByteArray &libname, const Entry &entry) const
+{
+    const QFileInfo fileInfo(entry.fileName);
+    return fileInfo.exists() && fileInfo.size() == entry.size && fileInfo.lastModified().toMSecsSinceEpoch() == entry.lastModified
+        && searchPathsStamp(libname) == entry.searchPaths;
+}
+
+void PluginMetaDataCache::stamp(const QByteArray &libname, Entry &entry) const
+{
+    const QFileInfo fileInfo(entry.fileName);
+    entry.size = fileInfo.size();
+    entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+    entry.searchPaths = searchPathsStamp(libname);
+}
+
+QString PluginMetaDataCache::searchPathsStamp(const QByteArray &libname)
+{
+    // Installing or removing a plugin touches its directory, which catches a
+    // plugin that now shadows the cached one from an earlier search path.
+    // Listing the search paths also catches changes of QT_PLUGIN_PATH.
+    const int slash = libname.lastIndexOf('/');
+    const QString subDirectory = slash > 0 ? QString::fromLatin1(libname.left(slash)) : QString();
+    QStringList stamps;
+    const QStringList libraryPaths = QCoreApplication::libraryPaths();
+    for (const QString &path : libraryPaths) {
+        const QFileInfo directory(subDirectory.isEmpty() ? path : path + u'/' + subDirectory);
+        stamps.append(path + u'=' + QString::number(directory.exists() ? directory.lastModified().toMSecsSinceEpoch() : -1));
+    }
+    return stamps.join(u';');
+}
+
+void PluginMetaDataCache::load()
+{
+    QFile file(mCacheFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version"_L1).toInt() != cacheFormatVersion) {
+        return;
+    }
+
+    const QJsonObject entries = root.value("entries"_L1).toObject();
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+        const QJsonObject object = it.value().toObject();
+        Entry entry;
+        entry.fileName = object.value("file"_L1).toString();
+        entry.size = object.value("size"_L1).toInteger(-1);
+        entry.lastModified = object.value("mtime"_L1).toInteger(-1);
+        entry.searchPaths = object.value("searchPaths"_L1).toString();
+        entry.metaData = object.value("metaData"_L1).toObject();
+        if (entry.fileName.isEmpty() || entry.metaData.isEmpty()) {
+            continue;
+        }
+        mEntries.insert(it.key().toLatin1(), entry);
+    }
+}
+
+void PluginMetaDataCache::scheduleSave()
+{
+    // Called with mMutex held, possibly from a worker thread
+    if (mSaveScheduled || !QCoreApplication::instance()) {
+        return;
+    }
+    mSaveScheduled = true;
+    QMetaObject::invokeMethod(
+        QCoreApplication::instance(),
+        [this]() {
+            QTimer::singleShot(saveDelay, QCoreApplication::instance(), [this]() {
+                QThreadPool::globalInstance()->start([this]() {
+                    save();
+                });
+            });
+        },
+        Qt::QueuedConnection);
+}
+
+void PluginMetaDataCache::saveAtExit()
+{
+    self()->save();
+}
+
+void PluginMetaDataCache::save()
+{
+    // Serializes the writers, but never blocks lookups while writing
+    QMutexLocker saveLocker(&mSaveMutex);
+
+    QJsonObject entries;
+    {
+        QMutexLocker locker(&mMutex);
+        mSaveScheduled = false;
+        if (!mDirty) {
+            return;
+        }
+        mDirty = false;
+        for (auto it = mEntries.constBegin(); it != mEntries.constEnd(); ++it) {
+            if (it->fileName.isEmpty() || !it->errorString.isEmpty()) {
+                continue;
+            }
+            const QJsonObject object{
+                {"file"_L1, it->fileName},
+                {"size"_L1, it->size},
+                {"mtime"_L1, it->lastModified},
+                {"searchPaths"_L1, it->searchPaths},
+                {"metaData"_L1, it->metaData},
+            };
+            entries.insert(QString::fromLatin1(it.key()), object);
+        }
+    }
+    const QJsonObject root{
+        {"version"_L1, cacheFormatVersion},
+        {"entries"_L1, entries},
+    };
+
+    QDir().mkpath(QFileInfo(mCacheFile).absolutePath());
+    QSaveFile file(mCacheFile);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KONTACTINTERFACE_LOG) << "error writing to" << mCacheFile;
+        return;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qCWarning(KONTACTINTERFACE_LOG) << "error writing to" << mCacheFile << file.errorString();
+    }
+}
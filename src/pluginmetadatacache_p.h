@@ -0,0 +1,87 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <KPluginMetaData>
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonObject>
+#include <QMutex>
+#include <QString>
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * On-disk cache of the metadata of part plugins.
+ *
+ * Entries are keyed by the library name passed to Core::createPart() and are
+ * only used as long as the resolved plugin file still has the recorded size and
+ * modification time, and as long as the plugin directories below
+ * QCoreApplication::libraryPaths() are unchanged, so a plugin installed into an
+ * earlier search path is picked up. The plugin file itself is not opened on a hit.
+ * Libraries that failed to load are remembered for the current session only.
+ *
+ * Changes are written back once, in the background, a while after the last
+ * insertion and when the application exits.
+ *
+ * All methods are thread-safe.
+ */
+class PluginMetaDataCache
+{
+public:
+    static PluginMetaDataCache *self();
+
+    /*!
+     * Looks up \a libname. Returns false on a cache miss. On a hit, either
+     * \a metaData is set or, for a library that is known to fail loading,
+     * \a errorString.
+     */
+    bool lookup(const QByteArray &libname, KPluginMetaData &metaData, QString &errorString);
+
+    /*!
+     * Remembers the resolved \a metaData of \a libname.
+     */
+    void insert(const QByteArray &libname, const KPluginMetaData &metaData);
+
+    /*!
+     * Remembers that \a libname, resolved to \a fileName, failed to load with
+     * \a errorString. Failures are only kept for the current session.
+     */
+    void insertFailure(const QByteArray &libname, const QString &fileName, const QString &errorString);
+
+private:
+    struct Entry {
+        QString fileName;
+        qint64 size = -1;
+        qint64 lastModified = -1;
+        QString searchPaths;
+        QJsonObject metaData;
+        QString errorString;
+    };
+
+    PluginMetaDataCache();
+    bool isUpToDate(const QByteArray &libname, const Entry &entry) const;
+    void stamp(const QByteArray &libname, Entry &entry) const;
+    [[nodiscard]] static QString searchPathsStamp(const QByteArray &libname);
+    void load();
+    void scheduleSave();
+    void save();
+    static void saveAtExit();
+
+    QMutex mMutex;
+    QHash<QByteArray, Entry> mEntries;
+    bool mDirty = false;
+    bool mSaveScheduled = false;
+    QMutex mSaveMutex;
+    const QString mCacheFile;
+};
+}
@@ -9,7 +9,7 @@
 /**
   @file
   This file is part of the KDEPIM Utilities library and provides
-  static methods for process handling (Windows only at this time).
+  static methods for process handling (Windows and Linux at this time).
 
   @author Jarosław Staniek \<staniek@kde.org\>
 */
@@ -168,4 +168,131 @@ void KontactInterface::activateWindowForProcess(const QString &executableName)
     SetForegroundWindow(winStruct.windowId);
 }
 
-#endif // Q_OS_WIN
+#elif defined(Q_OS_LINUX)
+
+#include "kontactinterface_debug.h"
+
+#include <QByteArray>
+#include <QString>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+// The kernel keeps at most this many characters of the command name
+static constexpr qsizetype maximumCommandNameLength = 15;
+
+// Reads the small file at path relative to dirFd, without the trailing newline
+static QByteArray readProcFile(int dirFd, const char *path)
+{
+    const int fd = openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return {};
+    }
+    char buffer[64];
+    const ssize_t length = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    if (length <= 0) {
+        return {};
+    }
+    QByteArray data(buffer, length);
+    if (data.endsWith('\n')) {
+        data.chop(1);
+    }
+    return data;
+}
+
+// Returns the real user ID from the status file of the process, or -1. The owner
+// of /proc/<pid> is root for processes that are not dumpable, e.g. after setuid
+// or prctl(PR_SET_DUMPABLE), so it cannot be used.
+static qint64 processUid(int dirFd, const char *pidName)
+{
+    char path[NAME_MAX + 8];
+    std::snprintf(path, sizeof(path), "%s/status", pidName);
+    const int fd = openat(dirFd, path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    // The Uid line comes within the first few hundred bytes
+    char buffer[1024];
+    const ssize_t length = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (length <= 0) {
+        return -1;
+    }
+    buffer[length] = '\0';
+    const char *line = std::strstr(buffer, "\nUid:");
+    if (!line) {
+        return -1;
+    }
+    char *end = nullptr;
+    const unsigned long uid = std::strtoul(line + 5, &end, 10);
+    return end == line + 5 ? -1 : qint64(uid);
+}
+
+void KontactInterface::getProcessesIdForName(const QString &processName, QList<int> &pids)
+{
+    pids.clear();
+
+    // One pass over the directory entries of /proc, the per-process files are
+    // opened relative to it so no path has to be resolved from the root
+    DIR *proc = opendir("/proc");
+    if (!proc) {
+        qCWarning(KONTACTINTERFACE_LOG) << "Could not open /proc:" << strerror(errno);
+        return;
+    }
+    const int procFd = dirfd(proc);
+    const uid_t uid = getuid();
+    const QByteArray name = processName.toLocal8Bit();
+    const QByteArray commandName = name.left(maximumCommandNameLength);
+
+    while (const dirent *entry = readdir(proc)) {
+        if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+            continue;
+        }
+        const char *pidName = entry->d_name;
+        if (pidName[0] < '1' || pidName[0] > '9') {
+            continue;
+        }
+
+        // The command name first, it rules out nearly every process
+        char path[NAME_MAX + 8];
+        std::snprintf(path, sizeof(path), "%s/comm", pidName);
+        if (readProcFile(procFd, path) != commandName) {
+            continue;
+        }
+
+        if (processUid(procFd, pidName) != qint64(uid)) {
+            continue;
+        }
+
+        if (name.size() > maximumCommandNameLength) {
+            std::snprintf(path, sizeof(path), "%s/exe", pidName);
+            char target[PATH_MAX];
+            const ssize_t length = readlinkat(procFd, path, target, sizeof(target));
+            if (length <= 0) {
+                continue;
+            }
+            QByteArray executable(target, length);
+            executable = executable.mid(executable.lastIndexOf('/') + 1);
+            if (executable.endsWith(" (deleted)")) {
+                executable.chop(10);
+            }
+            if (executable != name) {
+                continue;
+            }
+        }
+
+        const int pid = std::atoi(pidName);
+        pids.append(pid);
+        qCDebug(KONTACTINTERFACE_LOG) << "found PID: " << pid;
+    }
+    closedir(proc);
+}
+
+#endif // Q_OS_WIN / Q_OS_LINUX
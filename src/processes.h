@@ -20,7 +20,7 @@
 
 #include <QList>
 
-#ifdef Q_OS_WIN
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
 #include "kontactinterface_export.h"
 #endif
 
@@ -28,11 +28,18 @@ class QString;
 
 namespace KontactInterface
 {
-#ifdef Q_OS_WIN
+#if defined(Q_OS_WIN) || defined(Q_OS_LINUX)
 /*!
  * Sets @a pids to a list of processes having name @a processName.
+ *
+ * Only processes of the current user are returned. On Linux the name is
+ * matched against the command name of the process, and against its executable
+ * when the name is too long for the kernel's command name.
  */
 KONTACTINTERFACE_EXPORT void getProcessesIdForName(const QString &processName, QList<int> &pids);
+#endif
+
+#ifdef Q_OS_WIN
 
 /*!
  * Activates window for first found process with executable @a executableName
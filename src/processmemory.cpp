@@ -0,0 +1,37 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "processmemory_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#ifdef Q_OS_LINUX
+#include <QFile>
+#include <QList>
+
+#include <unistd.h>
+#endif
+
+qint64 KontactInterface::residentMemory()
+{
+#ifdef Q_OS_LINUX
+    // Second field of statm is the resident set size in pages
+    QFile file(u"/proc/self/statm"_s);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return -1;
+    }
+    const QList<QByteArray> fields = file.readLine().split(' ');
+    if (fields.size() < 2) {
+        return -1;
+    }
+    bool ok = false;
+    const qint64 pages = fields.at(1).toLongLong(&ok);
+    return ok ? pages * sysconf(_SC_PAGESIZE) : -1;
+#else
+    return -1;
+#endif
+}
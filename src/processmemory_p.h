@@ -0,0 +1,22 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QtGlobal>
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Returns the resident memory of the current process in bytes, or -1 where
+ * this is not known.
+ */
+qint64 residentMemory();
+}
@@ -0,0 +1,130 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "servicenameregistrar_p.h"
+
+#include "kontactinterface_debug.h"
+#include "tracing_p.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QFuture>
+#include <QPointer>
+#include <QPromise>
+
+using namespace KontactInterface;
+
+ServiceNameRegistrar *ServiceNameRegistrar::self()
+{
+    static QPointer<ServiceNameRegistrar> s_registrar;
+    if (!s_registrar) {
+        s_registrar = new ServiceNameRegistrar(QCoreApplication::instance());
+    }
+    return s_registrar;
+}
+
+ServiceNameRegistrar::ServiceNameRegistrar(QObject *parent)
+    : QObject(parent)
+{
+    mPool.setMaxThreadCount(1);
+}
+
+QFuture<bool> ServiceNameRegistrar::registerService(const QString &serviceName)
+{
+    if (mNames.value(serviceName, State::Registering) == State::Registered) {
+        return QtFuture::makeReadyValueFuture(true);
+    }
+    return startRegistration(serviceName).finished;
+}
+
+bool ServiceNameRegistrar::registerServiceNow(const QString &serviceName)
+{
+    if (mNames.value(serviceName, State::Registering) == State::Registered) {
+        return true;
+    }
+    const Registration registration = startRegistration(serviceName);
+    // Not the finished future, its continuation needs this thread. Going
+    // through the pool keeps the order with releases queued before.
+    registration.registered.waitForFinished();
+    const bool success = registration.registered.result();
+    finishRegistration(serviceName, registration.id, success);
+    return success;
+}
+
+ServiceNameRegistrar::Registration ServiceNameRegistrar::startRegistration(const QString &serviceName)
+{
+    const auto it = mNames.find(serviceName);
+    if (it != mNames.end()) {
+        if (it.value() == State::RegisteringThenRelease) {
+            // Wanted again before the release happened
+            it.value() = State::Registering;
+        }
+        return mPending.value(serviceName);
+    }
+    mNames.insert(serviceName, State::Registering);
+
+    auto promise = std::make_shared<QPromise<bool>>();
+    Registration registration;
+    registration.id = mNextId++;
+    registration.registered = promise->future();
+    promise->start();
+    mPool.start([promise, serviceName]() {
+        const TraceSpan span("ServiceNameRegistrar::registerService");
+        promise->addResult(QDBusConnection::sessionBus().registerService(serviceName));
+        promise->finish();
+    });
+    registration.finished = registration.registered.then(this, [this, serviceName, id = registration.id](bool success) {
+        finishRegistration(serviceName, id, success);
+        return success;
+    });
+    mPending.insert(serviceName, registration);
+    return registration;
+}
+
+void ServiceNameRegistrar::unregisterService(const QString &serviceName)
+{
+    const auto it = mNames.find(serviceName);
+    if (it == mNames.end()) {
+        return;
+    }
+    if (it.value() == State::Registered) {
+        mNames.erase(it);
+        releaseInBackground(serviceName);
+    } else {
+        it.value() = State::RegisteringThenRelease;
+    }
+}
+
+void ServiceNameRegistrar::finishRegistration(const QString &serviceName, quint64 id, bool success)
+{
+    // registerServiceNow() may have finished it already
+    const auto pending = mPending.constFind(serviceName);
+    if (pending == mPending.constEnd() || pending->id != id) {
+        return;
+    }
+    mPending.erase(pending);
+    const State state = mNames.value(serviceName, State::RegisteringThenRelease);
+    if (!success) {
+        qCWarning(KONTACTINTERFACE_LOG) << "Could not register" << serviceName << "on the session bus";
+        mNames.remove(serviceName);
+    } else if (state == State::RegisteringThenRelease) {
+        mNames.remove(serviceName);
+        releaseInBackground(serviceName);
+    } else {
+        mNames.insert(serviceName, State::Registered);
+    }
+}
+
+void ServiceNameRegistrar::releaseInBackground(const QString &serviceName)
+{
+    mPool.start([serviceName]() {
+        QDBusConnection::sessionBus().unregisterService(serviceName);
+    });
+}
+
+#include "moc_servicenameregistrar_p.cpp"
@@ -0,0 +1,86 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QFuture>
+#include <QHash>
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Registers names on the session bus, optionally without blocking the caller.
+ *
+ * QDBusConnection::registerService() waits for the RequestName reply of the
+ * bus daemon. Here it runs on the thread pool, so callers that can wait for the
+ * result carry on with the startup, and QtDBus still learns about the name,
+ * which it needs to deliver calls to our own names locally. Requests for a
+ * name that is already registered or being registered are merged, also with
+ * the blocking registerServiceNow().
+ */
+class ServiceNameRegistrar : public QObject
+{
+    Q_OBJECT
+
+public:
+    static ServiceNameRegistrar *self();
+
+    /*!
+     * Registers \a serviceName unless that is already done or under way.
+     * The returned future finishes once the registration did, its result
+     * tells whether we own the name now.
+     */
+    QFuture<bool> registerService(const QString &serviceName);
+
+    /*!
+     * Registers \a serviceName like registerService(), but returns only once
+     * that finished, telling whether we own the name.
+     */
+    bool registerServiceNow(const QString &serviceName);
+
+    /*!
+     * Releases \a serviceName, once its registration finished if it is still
+     * under way.
+     */
+    void unregisterService(const QString &serviceName);
+
+private:
+    explicit ServiceNameRegistrar(QObject *parent);
+
+    enum class State {
+        Registering,
+        // Released as soon as the registration finished
+        RegisteringThenRelease,
+        Registered,
+    };
+
+    struct Registration {
+        quint64 id = 0;
+        // Result of the bus call, finishes on the pool thread
+        QFuture<bool> registered;
+        // Finishes after finishRegistration() ran on our thread
+        QFuture<bool> finished;
+    };
+
+    [[nodiscard]] Registration startRegistration(const QString &serviceName);
+    void finishRegistration(const QString &serviceName, quint64 id, bool success);
+    void releaseInBackground(const QString &serviceName);
+
+    // A single thread, so requests and releases reach the bus daemon in order
+    QThreadPool mPool;
+    QHash<QString, State> mNames;
+    // Registrations under way, shared by everyone asking for the same name
+    QHash<QString, Registration> mPending;
+    quint64 mNextId = 1;
+};
+}
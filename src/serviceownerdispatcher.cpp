@@ -0,0 +1,80 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "serviceownerdispatcher_p.h"
+
+#include "kontactinterface_debug.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusServiceWatcher>
+
+using namespace KontactInterface;
+
+ServiceOwnerDispatcher *ServiceOwnerDispatcher::self()
+{
+    static QPointer<ServiceOwnerDispatcher> s_dispatcher;
+    if (!s_dispatcher) {
+        s_dispatcher = new ServiceOwnerDispatcher(QCoreApplication::instance());
+    }
+    return s_dispatcher;
+}
+
+ServiceOwnerDispatcher::ServiceOwnerDispatcher(QObject *parent)
+    : QObject(parent)
+    , mWatcher(new QDBusServiceWatcher(this))
+{
+    mWatcher->setConnection(QDBusConnection::sessionBus());
+    mWatcher->setWatchMode(QDBusServiceWatcher::WatchForOwnerChange);
+    connect(mWatcher, &QDBusServiceWatcher::serviceOwnerChanged, this, &ServiceOwnerDispatcher::dispatch);
+}
+
+void ServiceOwnerDispatcher::watch(const QString &serviceName, QObject *receiver, const Callback &callback)
+{
+    QList<Receiver> &receivers = mReceivers[serviceName];
+    if (receivers.isEmpty()) {
+        mWatcher->addWatchedService(serviceName);
+    }
+    Receiver entry;
+    entry.object = receiver;
+    entry.callback = callback;
+    receivers.append(entry);
+}
+
+void ServiceOwnerDispatcher::unwatch(const QString &serviceName, QObject *receiver)
+{
+    const auto it = mReceivers.find(serviceName);
+    if (it == mReceivers.end()) {
+        return;
+    }
+    it->removeIf([receiver](const Receiver &entry) {
+        return !entry.object || entry.object == receiver;
+    });
+    if (it->isEmpty()) {
+        mReceivers.erase(it);
+        mWatcher->removeWatchedService(serviceName);
+    }
+}
+
+void ServiceOwnerDispatcher::dispatch(const QString &serviceName, const QString &oldOwner, const QString &newOwner)
+{
+    const auto it = mReceivers.constFind(serviceName);
+    if (it == mReceivers.constEnd()) {
+        return;
+    }
+    qCDebug(KONTACTINTERFACE_LOG) << serviceName << "owner changed from" << oldOwner << "to" << newOwner;
+    // Copied, the callbacks may unwatch
+    const QList<Receiver> receivers = it.value();
+    for (const Receiver &receiver : receivers) {
+        if (receiver.object) {
+            receiver.callback(oldOwner, newOwner);
+        }
+    }
+}
+
+#include "moc_serviceownerdispatcher_p.cpp"
@@ -0,0 +1,63 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+#include <functional>
+
+class QDBusServiceWatcher;
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Process-wide watcher for owner changes of session bus names.
+ *
+ * Only the watched names get match rules on the bus, so the bus daemon does
+ * not send us every name change of the session. Changes are routed to the
+ * interested receivers through a hash of the service name.
+ */
+class ServiceOwnerDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QString &oldOwner, const QString &newOwner)>;
+
+    static ServiceOwnerDispatcher *self();
+
+    /*!
+     * Calls \a callback whenever the owner of \a serviceName changes, until
+     * unwatch() is called for \a receiver or \a receiver is destroyed.
+     */
+    void watch(const QString &serviceName, QObject *receiver, const Callback &callback);
+
+    /*!
+     * Stops calling the callback registered by \a receiver for \a serviceName.
+     */
+    void unwatch(const QString &serviceName, QObject *receiver);
+
+private:
+    explicit ServiceOwnerDispatcher(QObject *parent);
+    void dispatch(const QString &serviceName, const QString &oldOwner, const QString &newOwner);
+
+    struct Receiver {
+        QPointer<QObject> object;
+        Callback callback;
+    };
+
+    QDBusServiceWatcher *const mWatcher;
+    QHash<QString, QList<Receiver>> mReceivers;
+};
+}
@@ -0,0 +1,76 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "serviceprobe_p.h"
+
+#include "kontactinterface_debug.h"
+
+#include <QCoreApplication>
+#include <QDBusConnection>
+#include <QDBusConnectionInterface>
+#include <QTimer>
+
+// Needed for wince build
+#undef interface
+
+using namespace KontactInterface;
+
+ServiceProbe *ServiceProbe::self()
+{
+    static ServiceProbe s_probe;
+    return &s_probe;
+}
+
+QString ServiceProbe::serviceOwner(const QString &serviceName)
+{
+    if (!mSnapshotValid) {
+        refresh();
+    }
+
+    // Answering without the bus saves both calls; a registered name still needs its owner
+    int roundTrips = 0;
+    QString owner;
+    if (mRegisteredNames.contains(serviceName)) {
+        const auto it = mOwners.constFind(serviceName);
+        if (it != mOwners.constEnd()) {
+            owner = it.value();
+        } else {
+            owner = QDBusConnection::sessionBus().interface()->serviceOwner(serviceName);
+            mOwners.insert(serviceName, owner);
+            roundTrips = 1;
+        }
+    }
+    mStatistics.roundTrips += roundTrips;
+    mStatistics.roundTripsSaved += 2 - roundTrips;
+
+    qCDebug(KONTACTINTERFACE_LOG) << serviceName << "owner:" << owner << "bus round trips:" << mStatistics.roundTrips
+                                  << "saved:" << mStatistics.roundTripsSaved;
+    return owner;
+}
+
+ServiceProbe::Statistics ServiceProbe::statistics() const
+{
+    return mStatistics;
+}
+
+void ServiceProbe::refresh()
+{
+    const QStringList names = QDBusConnection::sessionBus().interface()->registeredServiceNames();
+    mRegisteredNames = QSet<QString>(names.cbegin(), names.cend());
+    mOwners.clear();
+    // Anything else may happen once control returns to the event loop
+    if (QCoreApplication::instance()) {
+        mSnapshotValid = true;
+        QTimer::singleShot(0, QCoreApplication::instance(), [this]() {
+            mSnapshotValid = false;
+        });
+    }
+    // The ListNames call replaces the first query's own calls
+    mStatistics.roundTrips += 1;
+    mStatistics.roundTripsSaved -= 1;
+}
@@ -0,0 +1,56 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Answers "who owns this service name" on the session bus for a burst of
+ * queries, such as all UniqueAppWatchers being created at startup.
+ *
+ * A single ListNames call tells which names are registered at all, the owner
+ * is only asked for (and remembered) for names that are. The snapshot is
+ * dropped on the next turn of the event loop, so it only answers queries made
+ * back to back and later queries see the current bus state.
+ */
+class ServiceProbe
+{
+public:
+    struct Statistics {
+        // Round trips to the bus daemon actually made
+        int roundTrips = 0;
+        // Round trips one isServiceRegistered() plus one serviceOwner() call per query would have made in addition
+        int roundTripsSaved = 0;
+    };
+
+    static ServiceProbe *self();
+
+    /*!
+     * Returns the unique name owning \a serviceName, or an empty string if the
+     * name is not registered.
+     */
+    [[nodiscard]] QString serviceOwner(const QString &serviceName);
+
+    [[nodiscard]] Statistics statistics() const;
+
+private:
+    void refresh();
+
+    QSet<QString> mRegisteredNames;
+    QHash<QString, QString> mOwners;
+    bool mSnapshotValid = false;
+    Statistics mStatistics;
+};
+}
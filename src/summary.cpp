@@ -10,18 +10,26 @@
 #include "summary.h"
 using namespace Qt::Literals::StringLiterals;
 
+#include "iconpixmapcache_p.h"
+#include "kontactinterface_debug.h"
+#include "summarytesthook_p.h"
+#include "summaryupdatescheduler_p.h"
+
 #include <QDrag>
 #include <QDragEnterEvent>
 #include <QDropEvent>
 #include <QFont>
 #include <QFontDatabase>
+#include <QGridLayout>
 #include <QHBoxLayout>
-#include <QIcon>
+#include <QHash>
 #include <QLabel>
 #include <QMimeData>
 #include <QMouseEvent>
 #include <QPainter>
 #include <QPixmap>
+#include <QPointer>
+#include <QSet>
 #include <QStyle>
 
 using namespace KontactInterface;
@@ -42,11 +50,165 @@ public:
 //@endcond
 
 //@cond PRIVATE
+// Width and height the drag pixmap is scaled down to
+static constexpr int maximumDragPixmapSize = 300;
+
 class Q_DECL_HIDDEN Summary::SummaryPrivate
 {
 public:
+    struct RowWidgets {
+        Row row;
+        QLabel *icon = nullptr;
+        QList<QLabel *> columns;
+        int position = -1;
+    };
+
+    QPixmap dragPixmap(Summary *q);
+    [[nodiscard]] static bool isEffectivelyVisible(const Summary *q);
+    void updateRowWidgets(Summary *q, RowWidgets &widgets, const Row &row, int position);
+    void placeRowWidgets(RowWidgets &widgets, int position);
+    static void deleteRowWidgets(const RowWidgets &widgets);
+
     QPoint mDragStartPoint;
+    // Rendered on the first drag, dropped when the content or the size changes
+    QPixmap mDragPixmap;
+    int mUpdatePriority = 0;
+    // Set while an update waits for the widget to become visible
+    bool mUpdateDeferred = false;
+    bool mDeferredForce = false;
+    QPointer<QGridLayout> mRowLayout;
+    int mFirstRow = 0;
+    QList<Row> mRows;
+    QHash<QString, RowWidgets> mRowWidgets;
 };
+
+QPixmap Summary::SummaryPrivate::dragPixmap(Summary *q)
+{
+    const qreal dpr = q->devicePixelRatioF();
+    if (!mDragPixmap.isNull() && qFuzzyCompare(mDragPixmap.devicePixelRatio(), dpr)) {
+        return mDragPixmap;
+    }
+
+    // Render straight at the thumbnail size instead of grabbing everything and scaling it down
+    QSize size = q->size();
+    qreal scale = 1.0;
+    if (size.width() > maximumDragPixmapSize) {
+        const QSize scaledSize = size.scaled(maximumDragPixmapSize, maximumDragPixmapSize, Qt::KeepAspectRatio);
+        scale = qreal(scaledSize.width()) / size.width();
+        size = scaledSize;
+    }
+
+    QPixmap pm(size * dpr);
+    pm.setDevicePixelRatio(dpr);
+    pm.fill(Qt::transparent);
+
+    QPainter painter;
+    painter.begin(&pm);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    painter.scale(scale, scale);
+    q->render(&painter, QPoint(), QRegion(), QWidget::DrawWindowBackground | QWidget::DrawChildren);
+    painter.resetTransform();
+    painter.setPen(QPalette::AlternateBase);
+    painter.drawRect(0, 0, size.width(), size.height());
+    painter.end();
+
+    mDragPixmap = pm;
+    return mDragPixmap;
+}
+
+QPixmap SummaryTestHook::dragPixmap(Summary *summary)
+{
+    return summary->d->dragPixmap(summary);
+}
+
+void SummaryTestHook::clearDragPixmap(Summary *summary)
+{
+    summary->d->mDragPixmap = QPixmap();
+}
+
+bool Summary::SummaryPrivate::isEffectivelyVisible(const Summary *q)
+{
+    if (!q->isVisible() || q->window()->isMinimized()) {
+        return false;
+    }
+    // Empty when clipped away by a parent, e.g. scrolled out of view
+    return !q->visibleRegion().isEmpty();
+}
+
+void Summary::SummaryPrivate::updateRowWidgets(Summary *q, RowWidgets &widgets, const Row &row, int position)
+{
+    if (row.iconName != widgets.row.iconName || !widgets.icon) {
+        if (row.iconName.isEmpty()) {
+            delete widgets.icon;
+            widgets.icon = nullptr;
+        } else {
+            if (!widgets.icon) {
+                widgets.icon = new QLabel(q);
+                widgets.icon->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+                widgets.position = -1;
+            }
+            const int size = q->style()->pixelMetric(QStyle::PM_SmallIconSize);
+            widgets.icon->setPixmap(IconPixmapCache::self()->pixmap(row.iconName, size, q->devicePixelRatioF()));
+        }
+    }
+
+    while (widgets.columns.size() > row.columns.size()) {
+        delete widgets.columns.takeLast();
+    }
+    for (qsizetype i = 0; i < row.columns.size(); ++i) {
+        if (i == widgets.columns.size()) {
+            auto label = new QLabel(row.columns.at(i), q);
+            label->setAlignment(Qt::AlignLeft | Qt::AlignVCenter);
+            QObject::connect(label, &QLabel::linkActivated, q, [q, key = row.key](const QString &link) {
+                Q_EMIT q->rowLinkActivated(key, link);
+            });
+            widgets.columns.append(label);
+            widgets.position = -1;
+        } else if (row.columns.at(i) != widgets.row.columns.value(i)) {
+            widgets.columns.at(i)->setText(row.columns.at(i));
+        }
+    }
+
+    if (row.toolTip != widgets.row.toolTip || widgets.position < 0) {
+        if (widgets.icon) {
+            widgets.icon->setToolTip(row.toolTip);
+        }
+        for (QLabel *label : std::as_const(widgets.columns)) {
+            label->setToolTip(row.toolTip);
+        }
+    }
+
+    widgets.row = row;
+    placeRowWidgets(widgets, position);
+    mDragPixmap = QPixmap();
+}
+
+void Summary::SummaryPrivate::placeRowWidgets(RowWidgets &widgets, int position)
+{
+    if (widgets.position == position) {
+        return;
+    }
+    widgets.position = position;
+    // Moving a widget to another cell means taking it out of the grid first
+    const int gridRow = mFirstRow + position;
+    if (widgets.icon) {
+        mRowLayout->removeWidget(widgets.icon);
+        mRowLayout->addWidget(widgets.icon, gridRow, 0);
+        widgets.icon->show();
+    }
+    for (qsizetype i = 0; i < widgets.columns.size(); ++i) {
+        QLabel *label = widgets.columns.at(i);
+        mRowLayout->removeWidget(label);
+        mRowLayout->addWidget(label, gridRow, int(i) + 1);
+        label->show();
+    }
+}
+
+void Summary::SummaryPrivate::deleteRowWidgets(const RowWidgets &widgets)
+{
+    delete widgets.icon;
+    qDeleteAll(widgets.columns);
+}
 //@endcond
 
 Summary::Summary(QWidget *parent)
@@ -72,11 +234,10 @@ QWidget *Summary::createHeader(QWidget *parent, const QString &iconname, const Q
     hbox->setSpacing(0);
     box->setAutoFillBackground(true);
 
-    QIcon icon = QIcon::fromTheme(iconname);
-
     auto label = new QLabel(box);
     hbox->addWidget(label);
-    label->setPixmap(icon.pixmap(style()->pixelMetric(QStyle::PM_ToolBarIconSize)));
+    const int size = style()->pixelMetric(QStyle::PM_ToolBarIconSize);
+    label->setPixmap(IconPixmapCache::self()->pixmap(iconname, size, devicePixelRatioF()));
 
     label->setFixedSize(label->sizeHint());
     label->setAcceptDrops(true);
@@ -95,6 +256,67 @@ QStringList Summary::configModules() const
     return {};
 }
 
+void Summary::setUpdatePriority(int priority)
+{
+    d->mUpdatePriority = priority;
+}
+
+int Summary::updatePriority() const
+{
+    return d->mUpdatePriority;
+}
+
+void Summary::setRowLayout(QGridLayout *layout, int firstRow)
+{
+    for (const auto &widgets : std::as_const(d->mRowWidgets)) {
+        SummaryPrivate::deleteRowWidgets(widgets);
+    }
+    d->mRowWidgets.clear();
+    d->mRows.clear();
+    d->mRowLayout = layout;
+    d->mFirstRow = firstRow;
+}
+
+void Summary::setRows(const QList<Row> &rows)
+{
+    if (!d->mRowLayout) {
+        qCWarning(KONTACTINTERFACE_LOG) << "Summary::setRows() called without a row layout";
+        return;
+    }
+    if (rows == d->mRows) {
+        return;
+    }
+
+    QSet<QString> keys;
+    keys.reserve(rows.size());
+    for (const Row &row : rows) {
+        keys.insert(row.key);
+    }
+    for (auto it = d->mRowWidgets.begin(); it != d->mRowWidgets.end();) {
+        if (keys.contains(it.key())) {
+            ++it;
+        } else {
+            SummaryPrivate::deleteRowWidgets(it.value());
+            it = d->mRowWidgets.erase(it);
+            d->mDragPixmap = QPixmap();
+        }
+    }
+
+    for (qsizetype i = 0; i < rows.size(); ++i) {
+        const Row &row = rows.at(i);
+        SummaryPrivate::RowWidgets &widgets = d->mRowWidgets[row.key];
+        if (widgets.row != row || widgets.position != i) {
+            d->updateRowWidgets(this, widgets, row, int(i));
+        }
+    }
+    d->mRows = rows;
+}
+
+QList<Summary::Row> Summary::rows() const
+{
+    return d->mRows;
+}
+
 void Summary::configChanged()
 {
 }
@@ -104,6 +326,57 @@ void Summary::updateSummary(bool force)
     Q_UNUSED(force)
 }
 
+void Summary::scheduleUpdate(bool force)
+{
+    if (d->mUpdateDeferred || !SummaryPrivate::isEffectivelyVisible(this)) {
+        d->mUpdateDeferred = true;
+        d->mDeferredForce = d->mDeferredForce || force;
+        return;
+    }
+    SummaryUpdateScheduler::self()->request(this, force);
+}
+
+void Summary::runScheduledUpdate(bool force)
+{
+    // The widget might have been hidden since the update was requested
+    if (!SummaryPrivate::isEffectivelyVisible(this)) {
+        d->mUpdateDeferred = true;
+        d->mDeferredForce = d->mDeferredForce || force;
+        return;
+    }
+    // Subclasses may change their content without going through setRows()
+    d->mDragPixmap = QPixmap();
+    updateSummary(force);
+}
+
+bool Summary::event(QEvent *event)
+{
+    switch (event->type()) {
+    case QEvent::Resize:
+    case QEvent::LayoutRequest:
+    case QEvent::StyleChange:
+    case QEvent::PaletteChange:
+    case QEvent::FontChange:
+    case QEvent::ChildAdded:
+    case QEvent::ChildRemoved:
+        d->mDragPixmap = QPixmap();
+        break;
+    case QEvent::Show:
+    case QEvent::Paint:
+        // Getting painted is the one sign of becoming visible that covers
+        // showing, restoring the window and scrolling into view alike
+        if (d->mUpdateDeferred && SummaryPrivate::isEffectivelyVisible(this)) {
+            const bool force = std::exchange(d->mDeferredForce, false);
+            d->mUpdateDeferred = false;
+            SummaryUpdateScheduler::self()->request(this, force);
+        }
+        break;
+    default:
+        break;
+    }
+    return QWidget::event(event);
+}
+
 void Summary::mousePressEvent(QMouseEvent *event)
 {
     d->mDragStartPoint = event->pos();
@@ -118,17 +391,7 @@ void Summary::mouseMoveEvent(QMouseEvent *event)
         drag->setMimeData(new SummaryMimeData());
         drag->setObjectName("SummaryWidgetDrag"_L1);
 
-        QPixmap pm = grab();
-        if (pm.width() > 300) {
-            pm = QPixmap::fromImage(pm.toImage().scaled(300, 300, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-        }
-
-        QPainter painter;
-        painter.begin(&pm);
-        painter.setPen(QPalette::AlternateBase);
-        painter.drawRect(0, 0, pm.width(), pm.height());
-        painter.end();
-        drag->setPixmap(pm);
+        drag->setPixmap(d->dragPixmap(this));
         drag->exec(Qt::MoveAction);
     } else {
         QWidget::mouseMoveEvent(event);
@@ -14,6 +14,7 @@
 class QMouseEvent;
 class QDragEnterEvent;
 class QDropEvent;
+class QGridLayout;
 
 namespace KontactInterface
 {
@@ -33,6 +34,46 @@ class KONTACTINTERFACE_EXPORT Summary : public QWidget
     Q_OBJECT
 
 public:
+    /*!
+     * \class KontactInterface::Summary::Row
+     * \inmodule KontactInterface
+     * \brief One row of the content shown by setRows().
+     * \since 6.8
+     */
+    struct Row {
+        /*!
+         * \variable KontactInterface::Summary::Row::key
+         * Identifies the row across calls of setRows(), e.g. the UID of the
+         * shown item. Keys must be unique within the rows.
+         */
+        QString key;
+        /*!
+         * \variable KontactInterface::Summary::Row::iconName
+         * The name of the icon shown in the first column, or empty for none.
+         */
+        QString iconName;
+        /*!
+         * \variable KontactInterface::Summary::Row::columns
+         * The texts of the following columns. They may contain rich text, links
+         * are reported by rowLinkActivated().
+         */
+        QStringList columns;
+        /*!
+         * \variable KontactInterface::Summary::Row::toolTip
+         * The tool tip of the whole row.
+         */
+        QString toolTip;
+
+        [[nodiscard]] bool operator==(const Row &other) const
+        {
+            return key == other.key && iconName == other.iconName && columns == other.columns && toolTip == other.toolTip;
+        }
+        [[nodiscard]] bool operator!=(const Row &other) const
+        {
+            return !operator==(other);
+        }
+    };
+
     /*!
      * Creates a new summary widget.
      *
@@ -69,6 +110,48 @@ public:
      */
     [[nodiscard]] virtual QStringList configModules() const;
 
+    /*!
+     * Sets the \a priority of this widget's scheduled updates.
+     *
+     * When several widgets have an update pending, the ones with the higher
+     * priority are updated first. The default is 0.
+     * \sa scheduleUpdate()
+     * \since 6.8
+     */
+    void setUpdatePriority(int priority);
+
+    /*!
+     * Returns the priority of this widget's scheduled updates.
+     * \since 6.8
+     */
+    [[nodiscard]] int updatePriority() const;
+
+    /*!
+     * Sets the \a layout setRows() puts the rows into, starting at the grid
+     * row \a firstRow. The layout must belong to this widget.
+     * \since 6.8
+     */
+    void setRowLayout(QGridLayout *layout, int firstRow = 0);
+
+    /*!
+     * Shows \a rows in the row layout.
+     *
+     * Rows are matched to the ones shown before by their key. Only rows that
+     * are new get widgets created, only vanished rows get their widgets deleted
+     * and only the labels whose content changed are updated, so a refresh that
+     * changes little costs little. Call this from updateSummary() instead of
+     * deleting and recreating the labels.
+     * \sa setRowLayout()
+     * \since 6.8
+     */
+    void setRows(const QList<Row> &rows);
+
+    /*!
+     * Returns the rows currently shown.
+     * \since 6.8
+     */
+    [[nodiscard]] QList<Row> rows() const;
+
 public Q_SLOTS:
     /*!
      * This method is called whenever the configuration has been changed.
@@ -82,6 +165,26 @@ public Q_SLOTS:
      */
     virtual void updateSummary(bool force = false);
 
+    /*!
+     * Requests a call of updateSummary() shortly, instead of updating right away.
+     *
+     * All requests for this widget until the next frame result in a single
+     * update, which is forced if any of the requests was. The updates of all
+     * summary widgets are run together in order of their updatePriority(), and
+     * a burst of them is spread over several frames.
+     *
+     * While the widget cannot be seen, because it is hidden, its window is
+     * minimized or it is scrolled out of view, the update is held back and
+     * done once when the widget shows up again.
+     *
+     * Connect data change notifications, configuration changes and
+     * Core::dayChanged() to this slot rather than to updateSummary().
+     *
+     * \a force true if the update was requested by the user
+     * \since 6.8
+     */
+    void scheduleUpdate(bool force = false);
+
 Q_SIGNALS:
     /*!
      * This signal can be emitted to signaling that an action is going on.
@@ -97,13 +200,25 @@ Q_SIGNALS:
      */
     void summaryWidgetDropped(QWidget *target, QObject *object, int alignment);
 
+    /*!
+     * This signal is emitted when the \a link in a column of the row \a key
+     * shown by setRows() has been activated.
+     * \since 6.8
+     */
+    void rowLinkActivated(const QString &key, const QString &link);
+
 protected:
+    bool event(QEvent *event) override;
     void mousePressEvent(QMouseEvent *) override;
     void mouseMoveEvent(QMouseEvent *) override;
     void dragEnterEvent(QDragEnterEvent *) override;
     void dropEvent(QDropEvent *) override;
 
 private:
+    friend class SummaryUpdateScheduler;
+    friend class SummaryTestHook;
+    void runScheduledUpdate(bool force);
+
     class SummaryPrivate;
     std::unique_ptr<SummaryPrivate> const d;
 };
@@ -0,0 +1,39 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include "kontactinterface_export.h"
+
+#include <QPixmap>
+
+namespace KontactInterface
+{
+class Summary;
+
+/*!
+ * \internal
+ *
+ * Reaches into Summary for the benchmarks, so they measure the code that runs
+ * on a drag instead of a copy of it.
+ */
+class KONTACTINTERFACE_EXPORT SummaryTestHook
+{
+public:
+    /*!
+     * Returns the pixmap a drag of \a summary shows, rendering it if it is
+     * not cached.
+     */
+    [[nodiscard]] static QPixmap dragPixmap(Summary *summary);
+
+    /*!
+     * Drops the cached drag pixmap of \a summary.
+     */
+    static void clearDragPixmap(Summary *summary);
+};
+}
@@ -0,0 +1,106 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "summaryupdatescheduler_p.h"
+
+#include "summary.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+
+using namespace KontactInterface;
+using namespace std::chrono_literals;
+
+SummaryUpdateScheduler *SummaryUpdateScheduler::self()
+{
+    static QPointer<SummaryUpdateScheduler> s_scheduler;
+    if (!s_scheduler) {
+        s_scheduler = new SummaryUpdateScheduler(QCoreApplication::instance());
+    }
+    return s_scheduler;
+}
+
+SummaryUpdateScheduler::SummaryUpdateScheduler(QObject *parent)
+    : QObject(parent)
+{
+    mTimer.setSingleShot(true);
+    connect(&mTimer, &QTimer::timeout, this, &SummaryUpdateScheduler::runPending);
+}
+
+void SummaryUpdateScheduler::request(Summary *summary, bool force)
+{
+    Request request;
+    request.summary = summary;
+    request.force = force;
+    enqueue(request);
+    // Not restarted by later requests, a steady stream of them must not postpone the update forever
+    if (!mTimer.isActive()) {
+        mTimer.start(frameInterval());
+    }
+}
+
+void SummaryUpdateScheduler::enqueue(const Request &request)
+{
+    for (Request &pending : mPending) {
+        if (pending.summary == request.summary) {
+            pending.force = pending.force || request.force;
+            return;
+        }
+    }
+    mPending.append(request);
+}
+
+void SummaryUpdateScheduler::runPending()
+{
+    // Requests made by the updates themselves wait for the next round
+    QList<Request> batch = std::exchange(mPending, {});
+    std::stable_sort(batch.begin(), batch.end(), [](const Request &lhs, const Request &rhs) {
+        const int lhsPriority = lhs.summary ? lhs.summary->updatePriority() : 0;
+        const int rhsPriority = rhs.summary ? rhs.summary->updatePriority() : 0;
+        return lhsPriority > rhsPriority;
+    });
+
+    const auto timeSlice = frameInterval() / 2;
+    QElapsedTimer timer;
+    timer.start();
+    qsizetype next = 0;
+    while (next < batch.size()) {
+        if (next > 0 && std::chrono::milliseconds(timer.elapsed()) >= timeSlice) {
+            break;
+        }
+        const Request &request = batch.at(next++);
+        if (request.summary) {
+            request.summary->runScheduledUpdate(request.force);
+        }
+    }
+
+    // Whatever did not fit into this frame goes first in the next one
+    const QList<Request> newRequests = std::exchange(mPending, batch.mid(next));
+    for (const Request &request : newRequests) {
+        enqueue(request);
+    }
+    if (!mPending.isEmpty()) {
+        mTimer.start(frameInterval());
+    }
+}
+
+std::chrono::milliseconds SummaryUpdateScheduler::frameInterval()
+{
+    const QScreen *screen = QGuiApplication::primaryScreen();
+    const qreal refreshRate = screen ? screen->refreshRate() : 0;
+    if (refreshRate <= 0) {
+        return 16ms;
+    }
+    return std::chrono::milliseconds(qMax(1, qRound(1000 / refreshRate)));
+}
+
+#include "moc_summaryupdatescheduler_p.cpp"
@@ -0,0 +1,58 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+
+#include <chrono>
+
+namespace KontactInterface
+{
+class Summary;
+
+/*!
+ * \internal
+ *
+ * Runs the update requests of all summary widgets of the process.
+ *
+ * Requests for the same widget are merged until the next frame, a forced
+ * request wins over a plain one. Pending updates run in order of the widgets'
+ * update priority, and only as many as fit into half a frame are run at once,
+ * so that a burst such as all widgets reacting to the day change is spread
+ * over several frames instead of blocking the summary view. Widgets that
+ * cannot be seen hold their update back until they are painted again.
+ */
+class SummaryUpdateScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static SummaryUpdateScheduler *self();
+
+    void request(Summary *summary, bool force);
+
+private:
+    explicit SummaryUpdateScheduler(QObject *parent);
+
+    struct Request {
+        QPointer<Summary> summary;
+        bool force = false;
+    };
+
+    void enqueue(const Request &request);
+    void runPending();
+    [[nodiscard]] static std::chrono::milliseconds frameInterval();
+
+    QList<Request> mPending;
+    QTimer mTimer;
+};
+}
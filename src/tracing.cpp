@@ -0,0 +1,109 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "tracing_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "kontactinterface_debug.h"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMutex>
+#include <QSaveFile>
+
+#include <atomic>
+#include <chrono>
+
+using namespace KontactInterface;
+
+namespace
+{
+struct TraceEvent {
+    const char *name = nullptr;
+    QString detail;
+    qint64 start = 0;
+    qint64 duration = 0;
+    int thread = 0;
+};
+
+QMutex s_mutex;
+QList<TraceEvent> s_events;
+bool s_flushRegistered = false;
+
+int currentThreadNumber()
+{
+    // Small numbers read better in trace viewers than thread handles
+    static std::atomic<int> s_nextThread{1};
+    thread_local const int thread = s_nextThread++;
+    return thread;
+}
+
+void writeTrace()
+{
+    const QString fileName = qEnvironmentVariable("KONTACTINTERFACE_TRACE_FILE");
+    const qint64 pid = QCoreApplication::applicationPid();
+
+    QJsonArray events;
+    {
+        QMutexLocker locker(&s_mutex);
+        for (const TraceEvent &event : std::as_const(s_events)) {
+            QJsonObject object{
+                {"name"_L1, QString::fromLatin1(event.name)},
+                {"cat"_L1, u"kontactinterface"_s},
+                {"ph"_L1, u"X"_s},
+                {"ts"_L1, event.start},
+                {"dur"_L1, event.duration},
+                {"pid"_L1, pid},
+                {"tid"_L1, event.thread},
+            };
+            if (!event.detail.isEmpty()) {
+                object.insert("args"_L1, QJsonObject{{"detail"_L1, event.detail}});
+            }
+            events.append(object);
+        }
+        s_events.clear();
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qCWarning(KONTACTINTERFACE_LOG) << "error writing trace to" << fileName;
+        return;
+    }
+    file.write(QJsonDocument(QJsonObject{{"traceEvents"_L1, events}, {"displayTimeUnit"_L1, u"ms"_s}}).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qCWarning(KONTACTINTERFACE_LOG) << "error writing trace to" << fileName << file.errorString();
+    }
+}
+}
+
+const bool TraceSpan::s_enabled = !qEnvironmentVariableIsEmpty("KONTACTINTERFACE_TRACE_FILE");
+
+qint64 TraceSpan::now()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceSpan::finish()
+{
+    TraceEvent event;
+    event.name = mName;
+    event.detail = mDetail ? QString::fromUtf8(mDetail) : mOwnedDetail;
+    event.start = mStart;
+    event.duration = now() - mStart;
+    event.thread = currentThreadNumber();
+
+    QMutexLocker locker(&s_mutex);
+    s_events.append(event);
+    if (!s_flushRegistered) {
+        s_flushRegistered = true;
+        qAddPostRoutine(writeTrace);
+    }
+}
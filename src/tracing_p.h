@@ -0,0 +1,78 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QString>
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Scoped span for tracing startup and activation.
+ *
+ * Tracing is enabled by setting KONTACTINTERFACE_TRACE_FILE to the path of a
+ * file; the spans of the process are written there on exit in the Chrome trace
+ * event format, which chrome://tracing and Perfetto can open.
+ *
+ * When tracing is disabled a span only tests a flag, so spans can stay in
+ * production code.
+ */
+class TraceSpan
+{
+public:
+    /*!
+     * Starts a span called \a name, optionally annotated with \a detail.
+     * Both strings must outlive the span.
+     */
+    explicit TraceSpan(const char *name, const char *detail = nullptr)
+        : mName(name)
+        , mDetail(detail)
+        , mStart(Q_UNLIKELY(s_enabled) ? now() : -1)
+    {
+    }
+
+    ~TraceSpan()
+    {
+        if (Q_UNLIKELY(mStart >= 0)) {
+            finish();
+        }
+    }
+
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /*!
+     * Returns whether the span is recorded, i.e. whether computing details is worth it.
+     */
+    [[nodiscard]] bool isActive() const
+    {
+        return mStart >= 0;
+    }
+
+    /*!
+     * Annotates the span with \a detail. Only call this if isActive().
+     */
+    void setDetail(const QString &detail)
+    {
+        mOwnedDetail = detail;
+    }
+
+private:
+    static qint64 now();
+    void finish();
+
+    static const bool s_enabled;
+
+    const char *const mName;
+    const char *const mDetail;
+    QString mOwnedDetail;
+    const qint64 mStart;
+};
+}
@@ -12,12 +12,19 @@ using namespace Qt::Literals::StringLiterals;
 #include "core.h"
 
 #include "processes.h"
+#include "servicenameregistrar_p.h"
+#include "serviceownerdispatcher_p.h"
+#include "serviceprobe_p.h"
+#include "tracing_p.h"
 
 #include "kontactinterface_debug.h"
 #include <kwindowsystem.h>
 
 #include <QDBusConnection>
 #include <QDBusConnectionInterface>
+#include <QDBusMetaType>
+#include <QDBusPendingCallWatcher>
+#include <QDBusPendingReply>
 
 #include <QCommandLineParser>
 
@@ -30,6 +37,13 @@ using namespace Qt::Literals::StringLiterals;
 #include <process.h>
 #endif
 
+#ifdef Q_OS_LINUX
+#include <QSocketNotifier>
+
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 /*
  Test plan for the various cases of interaction between standalone apps and kontact:
 
@@ -74,7 +88,14 @@ using namespace KontactInterface;
 class UniqueAppHandler::UniqueAppHandlerPrivate
 {
 public:
+    void activateMainWindow();
+
     Plugin *mPlugin = nullptr;
+    // Set up with the plugin's options on the first call, every parse starts from scratch
+    std::unique_ptr<QCommandLineParser> mParser;
+    // While handling newInstances(), activate() leaves showing the window to the end
+    bool mBatching = false;
+    bool mActivationPending = false;
 };
 //@endcond
 
@@ -85,23 +106,32 @@ UniqueAppHandler::UniqueAppHandler(Plugin *plugin)
     qCDebug(KONTACTINTERFACE_LOG) << "plugin->objectName():" << plugin->objectName();
 
     d->mPlugin = plugin;
+    // For newInstances()
+    qDBusRegisterMetaType<QList<QStringList>>();
     QDBusConnection session = QDBusConnection::sessionBus();
     const QString appName = plugin->objectName();
-    session.registerService("org.kde."_L1 + appName);
+    // Same name as Plugin::registerClient(), the registrar asks the bus only once.
+    // The name must be ours before the object can be found, a second start of
+    // the application would not see us and run standalone otherwise.
+    ServiceNameRegistrar::self()->registerServiceNow("org.kde."_L1 + appName);
     const QString objectName = u'/' + appName + "_PimApplication"_L1;
     session.registerObject(objectName, this, QDBusConnection::ExportAllSlots);
 }
 
 UniqueAppHandler::~UniqueAppHandler()
 {
-    QDBusConnection session = QDBusConnection::sessionBus();
     const QString appName = parent()->objectName();
-    session.unregisterService("org.kde."_L1 + appName);
+    ServiceNameRegistrar::self()->unregisterService("org.kde."_L1 + appName);
 }
 
 // DBUS call
 int UniqueAppHandler::newInstance(const QByteArray &startupId, const QStringList &args, const QString &workingDirectory)
 {
+    TraceSpan span("UniqueAppHandler::newInstance");
+    if (span.isActive()) {
+        span.setDetail(d->mPlugin->objectName());
+    }
+
     if (KWindowSystem::isPlatformX11()) {
 #if KONTACTINTERFACE_HAVE_X11
         KStartupInfo::setStartupId(startupId);
@@ -110,13 +140,36 @@ int UniqueAppHandler::newInstance(const QByteArray &startupId, const QStringList
         KWindowSystem::setCurrentXdgActivationToken(QString::fromUtf8(startupId));
     }
 
-    QCommandLineParser parser;
-    loadCommandLineOptions(&parser); // implemented by plugin
-    parser.process(args);
+    if (!d->mParser) {
+        d->mParser = std::make_unique<QCommandLineParser>();
+        loadCommandLineOptions(d->mParser.get()); // implemented by plugin
+    }
+    d->mParser->process(args);
 
     return activate(args, workingDirectory);
 }
 
+// DBUS call
+int UniqueAppHandler::newInstances(const QByteArray &asn_id, const QList<QStringList> &argumentLists, const QString &workingDirectory)
+{
+    TraceSpan span("UniqueAppHandler::newInstances");
+    if (span.isActive()) {
+        span.setDetail(d->mPlugin->objectName());
+    }
+
+    d->mBatching = true;
+    int result = 0;
+    for (const QStringList &args : argumentLists) {
+        result = newInstance(asn_id, args, workingDirectory);
+    }
+    d->mBatching = false;
+
+    if (std::exchange(d->mActivationPending, false)) {
+        d->activateMainWindow();
+    }
+    return result;
+}
+
 static QWidget *s_mainWidget = nullptr;
 
 // Plugin-specific newInstance implementation, called by above method
@@ -125,6 +178,17 @@ int KontactInterface::UniqueAppHandler::activate(const QStringList &args, const
     Q_UNUSED(args)
     Q_UNUSED(workingDirectory)
 
+    if (d->mBatching) {
+        d->mActivationPending = true;
+    } else {
+        d->activateMainWindow();
+    }
+    return 0;
+}
+
+//@cond PRIVATE
+void UniqueAppHandler::UniqueAppHandlerPrivate::activateMainWindow()
+{
     if (s_mainWidget) {
         s_mainWidget->show();
         KWindowSystem::activateWindow(s_mainWidget->windowHandle());
@@ -134,9 +198,9 @@ int KontactInterface::UniqueAppHandler::activate(const QStringList &args, const
     }
 
     // Then ensure the part appears in kontact
-    d->mPlugin->core()->selectPlugin(d->mPlugin);
-    return 0;
+    mPlugin->core()->selectPlugin(mPlugin);
 }
+//@endcond
 
 Plugin *UniqueAppHandler::plugin() const
 {
@@ -156,6 +220,24 @@ public:
     UniqueAppHandlerFactoryBase *mFactory = nullptr;
     Plugin *mPlugin = nullptr;
     bool mRunningStandalone;
+#ifdef Q_OS_LINUX
+    // Becomes readable when the standalone application exits
+    int mPidFd = -1;
+    QSocketNotifier *mPidNotifier = nullptr;
+
+    void closePidFd()
+    {
+        if (mPidFd < 0) {
+            return;
+        }
+        // We might be in the notifier's own signal
+        mPidNotifier->setEnabled(false);
+        mPidNotifier->deleteLater();
+        mPidNotifier = nullptr;
+        ::close(mPidFd);
+        mPidFd = -1;
+    }
+#endif
 };
 //@endcond
 
@@ -163,14 +245,20 @@ UniqueAppWatcher::UniqueAppWatcher(UniqueAppHandlerFactoryBase *factory, Plugin
     : QObject(plugin)
     , d(new UniqueAppWatcherPrivate)
 {
+    TraceSpan span("UniqueAppWatcher");
+    if (span.isActive()) {
+        span.setDetail(plugin->objectName());
+    }
+
     d->mFactory = factory;
     d->mPlugin = plugin;
 
     // The app is running standalone if 1) that name is known to D-Bus
     const QString serviceName = "org.kde."_L1 + plugin->objectName();
-    // Needed for wince build
-#undef interface
-    d->mRunningStandalone = QDBusConnection::sessionBus().interface()->isServiceRegistered(serviceName);
+    // All watchers are typically created in a burst at startup, the probe
+    // answers them from one snapshot of the bus instead of asking each time
+    const QString owner = ServiceProbe::self()->serviceOwner(serviceName);
+    d->mRunningStandalone = !owner.isEmpty();
 #ifdef Q_OS_WIN
     if (d->mRunningStandalone) {
         QList<int> pids;
@@ -189,7 +277,7 @@ UniqueAppWatcher::UniqueAppWatcher(UniqueAppHandlerFactoryBase *factory, Plugin
     }
 #endif
 
-    QString owner = QDBusConnection::sessionBus().interface()->serviceOwner(serviceName);
+    // 2) it is not us
     if (d->mRunningStandalone && (owner == QDBusConnection::sessionBus().baseService())) {
         d->mRunningStandalone = false;
     }
@@ -197,10 +285,41 @@ UniqueAppWatcher::UniqueAppWatcher(UniqueAppHandlerFactoryBase *factory, Plugin
     qCDebug(KONTACTINTERFACE_LOG) << " plugin->objectName()=" << plugin->objectName() << " running standalone:" << d->mRunningStandalone;
 
     if (d->mRunningStandalone) {
-        QObject::connect(QDBusConnection::sessionBus().interface(),
-                         &QDBusConnectionInterface::serviceOwnerChanged,
-                         this,
-                         &UniqueAppWatcher::slotApplicationRemoved);
+        ServiceOwnerDispatcher::self()->watch(serviceName, this, [this, serviceName](const QString &oldOwner, const QString &newOwner) {
+            slotApplicationRemoved(serviceName, oldOwner, newOwner);
+        });
+#if defined(Q_OS_LINUX) && defined(SYS_pidfd_open)
+        // The bus knows the process behind the name, also across PID namespaces
+        auto pidCall =
+            new QDBusPendingCallWatcher(QDBusConnection::sessionBus().interface()->asyncCall(u"GetConnectionUnixProcessID"_s, owner), this);
+        connect(pidCall, &QDBusPendingCallWatcher::finished, this, [this, serviceName, owner](QDBusPendingCallWatcher *call) {
+            call->deleteLater();
+            const QDBusPendingReply<uint> pid = *call;
+            // The application may have gone away while we were asking
+            if (pid.isError() || !d->mRunningStandalone || d->mPidFd >= 0) {
+                return;
+            }
+            d->mPidFd = int(syscall(SYS_pidfd_open, pid.value(), 0));
+            if (d->mPidFd < 0) {
+                return;
+            }
+            d->mPidNotifier = new QSocketNotifier(d->mPidFd, QSocketNotifier::Read, this);
+            connect(d->mPidNotifier, &QSocketNotifier::activated, this, [this, serviceName, owner]() {
+                qCDebug(KONTACTINTERFACE_LOG) << serviceName << "exited";
+                d->closePidFd();
+                // Only a hint, the handler cannot own the name before the bus
+                // dropped it. Otherwise the owner change takes care of it.
+                auto call = new QDBusPendingCallWatcher(QDBusConnection::sessionBus().interface()->asyncCall(u"NameHasOwner"_s, serviceName), this);
+                connect(call, &QDBusPendingCallWatcher::finished, this, [this, serviceName, owner](QDBusPendingCallWatcher *watcher) {
+                    watcher->deleteLater();
+                    const QDBusPendingReply<bool> reply = *watcher;
+                    if (!reply.isError() && !reply.value()) {
+                        slotApplicationRemoved(serviceName, owner, QString());
+                    }
+                });
+            });
+        });
+#endif
     } else {
         d->mFactory->createHandler(d->mPlugin);
     }
@@ -208,6 +327,15 @@ UniqueAppWatcher::UniqueAppWatcher(UniqueAppHandlerFactoryBase *factory, Plugin
 
 UniqueAppWatcher::~UniqueAppWatcher()
 {
+    if (d->mRunningStandalone) {
+        ServiceOwnerDispatcher::self()->unwatch("org.kde."_L1 + d->mPlugin->objectName(), this);
+    }
+#ifdef Q_OS_LINUX
+    if (d->mPidFd >= 0) {
+        delete d->mPidNotifier;
+        ::close(d->mPidFd);
+    }
+#endif
     delete d->mFactory;
 }
 
@@ -224,6 +352,10 @@ void KontactInterface::UniqueAppWatcher::slotApplicationRemoved(const QString &n
 
     const QString serviceName = "org.kde."_L1 + d->mPlugin->objectName();
     if (name == serviceName && d->mRunningStandalone) {
+        ServiceOwnerDispatcher::self()->unwatch(serviceName, this);
+#ifdef Q_OS_LINUX
+        d->closePidFd();
+#endif
         d->mFactory->createHandler(d->mPlugin);
         d->mRunningStandalone = false;
     }
@@ -58,6 +58,13 @@ public:
 
 public Q_SLOTS: // DBUS methods
     int newInstance(const QByteArray &asn_id, const QStringList &args, const QString &workingDirectory);
+
+    /*!
+     * Handles all \a argumentLists like newInstance(), but shows the main
+     * window and selects the plugin only once for the whole batch.
+     * \since 6.8
+     */
+    int newInstances(const QByteArray &asn_id, const QList<QStringList> &argumentLists, const QString &workingDirectory);
     bool load();
 
 protected:
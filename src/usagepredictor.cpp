@@ -0,0 +1,185 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "usagepredictor_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "core.h"
+#include "kontactinterface_debug.h"
+#include "plugin.h"
+
+#include <KSharedConfig>
+
+#include <algorithm>
+
+using namespace KontactInterface;
+using namespace std::chrono_literals;
+
+namespace
+{
+// Key of the plugins selected first in a session
+constexpr QLatin1StringView sessionStartKey("SessionStart");
+// How many parts are prepared after each switch
+constexpr int maximumPredictions = 2;
+// Successors seen less often than this are not worth loading
+constexpr int minimumCount = 2;
+// Counts of a plugin are halved once their sum exceeds this, so old habits fade
+constexpr int maximumTotalCount = 200;
+// Give the selected part time to show up before loading others
+constexpr auto prepareDelay = 1s;
+}
+
+UsagePredictor::UsagePredictor(Core *core)
+    : QObject(core)
+    , mCore(core)
+    , mGroup(KSharedConfig::openStateConfig(), u"KontactPartUsage"_s)
+{
+    mPrepareTimer.setSingleShot(true);
+    mPrepareTimer.setInterval(prepareDelay);
+    connect(&mPrepareTimer, &QTimer::timeout, this, &UsagePredictor::prepare);
+}
+
+void UsagePredictor::setPreloadEnabled(bool enabled)
+{
+    mPreloadEnabled = enabled;
+    if (enabled) {
+        mPredicted = predict(currentKey());
+        mPrepareTimer.start();
+    } else {
+        mPrepareTimer.stop();
+    }
+}
+
+void UsagePredictor::setThrottled(bool throttled)
+{
+    mThrottled = throttled;
+    if (throttled) {
+        mPrepareTimer.stop();
+    }
+}
+
+void UsagePredictor::recordSelection(Plugin *plugin)
+{
+    const QString key = keyOf(plugin);
+    if (key == mLastSelected) {
+        return;
+    }
+
+    if (!mPredicted.isEmpty()) {
+        if (mPredicted.contains(key)) {
+            ++mHits;
+        } else {
+            ++mMisses;
+        }
+        qCDebug(KONTACTINTERFACE_LOG) << "Part prediction" << mPredicted << "selected" << key << "hits:" << mHits << "misses:" << mMisses;
+    }
+
+    storeTransition(currentKey(), key);
+    mLastSelected = key;
+
+    mPredicted = predict(key);
+    if (mPreloadEnabled) {
+        mPrepareTimer.start();
+    }
+}
+
+int UsagePredictor::hits() const
+{
+    return mHits;
+}
+
+int UsagePredictor::misses() const
+{
+    return mMisses;
+}
+
+QHash<QString, int> UsagePredictor::successors(const QString &key) const
+{
+    QHash<QString, int> counts;
+    const QStringList entries = mGroup.readEntry(key, QStringList());
+    for (const QString &entry : entries) {
+        const qsizetype separator = entry.lastIndexOf(u'=');
+        if (separator > 0) {
+            counts.insert(entry.left(separator), entry.mid(separator + 1).toInt());
+        }
+    }
+    return counts;
+}
+
+QStringList UsagePredictor::predict(const QString &key) const
+{
+    const QHash<QString, int> counts = successors(key);
+    QList<QPair<int, QString>> candidates;
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        if (it.value() >= minimumCount && it.key() != key) {
+            candidates.append({it.value(), it.key()});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto &lhs, const auto &rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    QStringList predicted;
+    for (const auto &candidate : std::as_const(candidates)) {
+        if (predicted.size() == maximumPredictions) {
+            break;
+        }
+        predicted.append(candidate.second);
+    }
+    return predicted;
+}
+
+void UsagePredictor::storeTransition(const QString &from, const QString &to)
+{
+    QHash<QString, int> counts = successors(from);
+    ++counts[to];
+
+    int total = 0;
+    for (int count : std::as_const(counts)) {
+        total += count;
+    }
+    const bool decay = total > maximumTotalCount;
+
+    QStringList entries;
+    entries.reserve(counts.size());
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        const int count = decay ? it.value() / 2 : it.value();
+        if (count > 0) {
+            entries.append(it.key() + u'=' + QString::number(count));
+        }
+    }
+    mGroup.writeEntry(from, entries);
+}
+
+void UsagePredictor::prepare()
+{
+    if (mPredicted.isEmpty() || mThrottled) {
+        return;
+    }
+
+    const QList<Plugin *> plugins = mCore->pluginList();
+    for (Plugin *plugin : plugins) {
+        if (!mPredicted.contains(keyOf(plugin)) || plugin->disabled() || plugin->isRunningStandalone()) {
+            continue;
+        }
+        qCDebug(KONTACTINTERFACE_LOG) << "Preparing predicted part of" << plugin->objectName();
+        (void)plugin->partAsync();
+    }
+}
+
+QString UsagePredictor::currentKey() const
+{
+    return mLastSelected.isEmpty() ? QString(sessionStartKey) : mLastSelected;
+}
+
+QString UsagePredictor::keyOf(const Plugin *plugin)
+{
+    return plugin->identifier().isEmpty() ? plugin->objectName() : plugin->identifier();
+}
+
+#include "moc_usagepredictor_p.cpp"
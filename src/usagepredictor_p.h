@@ -0,0 +1,67 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <KConfigGroup>
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+#include <QTimer>
+
+namespace KontactInterface
+{
+class Core;
+class Plugin;
+
+/*!
+ * \internal
+ *
+ * Learns in which order the user switches between plugins and loads the parts
+ * most likely needed next ahead of time.
+ *
+ * The history is a table of how often each plugin followed each other plugin,
+ * plus which plugin is selected first in a session. It is kept in the state
+ * config, one entry per plugin listing the counts of its successors.
+ */
+class UsagePredictor : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UsagePredictor(Core *core);
+
+    void setPreloadEnabled(bool enabled);
+    // Holds predicted parts back, e.g. while the memory budget is exceeded
+    void setThrottled(bool throttled);
+    void recordSelection(Plugin *plugin);
+
+    [[nodiscard]] int hits() const;
+    [[nodiscard]] int misses() const;
+
+private:
+    [[nodiscard]] QHash<QString, int> successors(const QString &key) const;
+    [[nodiscard]] QStringList predict(const QString &key) const;
+    void storeTransition(const QString &from, const QString &to);
+    void prepare();
+    [[nodiscard]] QString currentKey() const;
+    [[nodiscard]] static QString keyOf(const Plugin *plugin);
+
+    Core *const mCore;
+    KConfigGroup mGroup;
+    QString mLastSelected;
+    QStringList mPredicted;
+    // Restarted on every switch, so quick switching loads nothing in between
+    QTimer mPrepareTimer;
+    int mHits = 0;
+    int mMisses = 0;
+    bool mPreloadEnabled = false;
+    bool mThrottled = false;
+};
+}
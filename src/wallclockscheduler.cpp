@@ -0,0 +1,216 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#include "wallclockscheduler_p.h"
+using namespace Qt::Literals::StringLiterals;
+
+#include "kontactinterface_debug.h"
+
+#include <QDBusConnection>
+#include <QSocketNotifier>
+#include <QTimer>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+using namespace KontactInterface;
+
+namespace
+{
+// Without a timerfd, wake up at least this often to notice clock changes
+constexpr qint64 maximumTimerInterval = 60 * 1000;
+// Without alarms, keep the timerfd armed this far ahead so clock changes are still reported
+constexpr qint64 idleTimerfdInterval = qint64(24) * 60 * 60 * 1000;
+// Difference between wall clock and monotonic clock progress treated as a clock change
+constexpr qint64 clockJumpThreshold = 2000;
+}
+
+WallClockScheduler::WallClockScheduler(QObject *parent)
+    : QObject(parent)
+{
+#ifdef Q_OS_LINUX
+    mTimerFd = timerfd_create(CLOCK_REALTIME, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (mTimerFd >= 0) {
+        mNotifier = new QSocketNotifier(mTimerFd, QSocketNotifier::Read, this);
+        connect(mNotifier, &QSocketNotifier::activated, this, [this]() {
+            quint64 expirations = 0;
+            if (::read(mTimerFd, &expirations, sizeof(expirations)) < 0 && errno == ECANCELED) {
+                qCDebug(KONTACTINTERFACE_LOG) << "System clock was set";
+                Q_EMIT clockChanged();
+            }
+            slotTimeout();
+        });
+    } else {
+        qCWarning(KONTACTINTERFACE_LOG) << "timerfd_create failed, falling back to polling the wall clock:" << strerror(errno);
+    }
+#endif
+    if (mTimerFd < 0) {
+        mTimer = new QTimer(this);
+        mTimer->setSingleShot(true);
+        mTimer->setTimerType(Qt::PreciseTimer);
+        connect(mTimer, &QTimer::timeout, this, &WallClockScheduler::slotTimeout);
+    }
+
+#ifdef Q_OS_UNIX
+    // Connecting to the system bus waits for the bus daemon, it is not needed
+    // before the first clock change anyway
+    QTimer::singleShot(0, this, &WallClockScheduler::watchSystemBus);
+#endif
+
+    mMonotonicClock.start();
+    mLastWallClock = QDateTime::currentMSecsSinceEpoch();
+    rearm();
+}
+
+WallClockScheduler::~WallClockScheduler()
+{
+#ifdef Q_OS_LINUX
+    if (mTimerFd >= 0) {
+        delete mNotifier;
+        ::close(mTimerFd);
+    }
+#endif
+}
+
+int WallClockScheduler::schedule(const QDateTime &dateTime, QObject *context, const std::function<void()> &callback)
+{
+    Alarm alarm;
+    alarm.id = mNextId++;
+    alarm.dateTime = dateTime;
+    alarm.context = context;
+    alarm.callback = callback;
+    mAlarms.append(alarm);
+    rearm();
+    return alarm.id;
+}
+
+void WallClockScheduler::cancel(int id)
+{
+    mAlarms.removeIf([id](const Alarm &alarm) {
+        return alarm.id == id;
+    });
+    rearm();
+}
+
+void WallClockScheduler::watchSystemBus()
+{
+#ifdef Q_OS_UNIX
+    // Matching on path and interface only, a service name would make QtDBus
+    // look up its owner with a blocking call
+    QDBusConnection systemBus = QDBusConnection::systemBus();
+    systemBus.connect(QString(),
+                      u"/org/freedesktop/timedate1"_s,
+                      u"org.freedesktop.DBus.Properties"_s,
+                      u"PropertiesChanged"_s,
+                      this,
+                      SLOT(slotTimeZoneChanged()));
+    systemBus.connect(QString(),
+                      u"/org/freedesktop/login1"_s,
+                      u"org.freedesktop.login1.Manager"_s,
+                      u"PrepareForSleep"_s,
+                      this,
+                      SLOT(slotPrepareForSleep(bool)));
+#endif
+}
+
+void WallClockScheduler::slotTimeZoneChanged()
+{
+    qCDebug(KONTACTINTERFACE_LOG) << "Time zone or time settings changed";
+    Q_EMIT clockChanged();
+    fireDueAlarms();
+    rearm();
+}
+
+void WallClockScheduler::slotPrepareForSleep(bool sleep)
+{
+    if (sleep) {
+        return;
+    }
+    qCDebug(KONTACTINTERFACE_LOG) << "Resumed from suspend";
+    Q_EMIT clockChanged();
+    fireDueAlarms();
+    rearm();
+}
+
+void WallClockScheduler::slotTimeout()
+{
+    if (mTimer) {
+        const qint64 now = QDateTime::currentMSecsSinceEpoch();
+        const qint64 monotonic = mMonotonicClock.restart();
+        if (qAbs((now - mLastWallClock) - monotonic) > clockJumpThreshold) {
+            qCDebug(KONTACTINTERFACE_LOG) << "System clock was set";
+            Q_EMIT clockChanged();
+        }
+        mLastWallClock = now;
+    }
+    fireDueAlarms();
+    rearm();
+}
+
+void WallClockScheduler::fireDueAlarms()
+{
+    const QDateTime now = QDateTime::currentDateTime();
+    QList<Alarm> due;
+    mAlarms.removeIf([&now, &due](const Alarm &alarm) {
+        if (!alarm.context) {
+            return true;
+        }
+        if (alarm.dateTime <= now) {
+            due.append(alarm);
+            return true;
+        }
+        return false;
+    });
+    // The callbacks may schedule new alarms
+    for (const Alarm &alarm : std::as_const(due)) {
+        if (alarm.context) {
+            alarm.callback();
+        }
+    }
+}
+
+void WallClockScheduler::rearm()
+{
+    qint64 next = -1;
+    for (const Alarm &alarm : std::as_const(mAlarms)) {
+        // Converted on every arming, alarms in local time follow time zone changes
+        const qint64 msecs = alarm.dateTime.toMSecsSinceEpoch();
+        if (next < 0 || msecs < next) {
+            next = msecs;
+        }
+    }
+
+#ifdef Q_OS_LINUX
+    if (mTimerFd >= 0) {
+        if (next < 0) {
+            next = QDateTime::currentMSecsSinceEpoch() + idleTimerfdInterval;
+        }
+        // A zero it_value would disarm the timer
+        next = qMax<qint64>(next, 1);
+        itimerspec spec = {};
+        spec.it_value.tv_sec = next / 1000;
+        spec.it_value.tv_nsec = (next % 1000) * 1000 * 1000;
+        if (timerfd_settime(mTimerFd, TFD_TIMER_ABSTIME | TFD_TIMER_CANCEL_ON_SET, &spec, nullptr) < 0) {
+            qCWarning(KONTACTINTERFACE_LOG) << "timerfd_settime failed:" << strerror(errno);
+        }
+        return;
+    }
+#endif
+
+    qint64 interval = maximumTimerInterval;
+    if (next >= 0) {
+        interval = qBound<qint64>(0, next - QDateTime::currentMSecsSinceEpoch(), maximumTimerInterval);
+    }
+    mTimer->start(std::chrono::milliseconds(interval));
+}
+
+#include "moc_wallclockscheduler_p.cpp"
@@ -0,0 +1,88 @@
+/*
+  This file is part of the KDE Kontact Plugin Interface Library.
+
+  SPDX-FileCopyrightText: 2026 KDE PIM Authors
+
+  SPDX-License-Identifier: LGPL-2.0-or-later
+*/
+
+#pragma once
+
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+#include <functional>
+
+class QSocketNotifier;
+class QTimer;
+
+namespace KontactInterface
+{
+/*!
+ * \internal
+ *
+ * Runs callbacks at given wall-clock times using a single timer armed for the
+ * earliest of them.
+ *
+ * On Linux this is a CLOCK_REALTIME timerfd with TFD_TIMER_CANCEL_ON_SET, so
+ * the process is woken up when the system clock is set and alarms that passed
+ * during suspend fire right on resume. Elsewhere a precise QTimer is used,
+ * capped to a minute so clock changes are noticed with the old latency.
+ * Time zone changes and resume are also picked up from systemd over D-Bus.
+ */
+class WallClockScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit WallClockScheduler(QObject *parent = nullptr);
+    ~WallClockScheduler() override;
+
+    /*!
+     * Calls \a callback once the wall clock reaches \a dateTime, unless \a context
+     * has been destroyed by then. Returns an identifier for cancel().
+     */
+    int schedule(const QDateTime &dateTime, QObject *context, const std::function<void()> &callback);
+
+    /*!
+     * Cancels the alarm \a id.
+     */
+    void cancel(int id);
+
+Q_SIGNALS:
+    /*!
+     * Emitted when the system clock was set, the time zone changed or the
+     * system resumed from suspend.
+     */
+    void clockChanged();
+
+private Q_SLOTS:
+    void slotTimeZoneChanged();
+    void slotPrepareForSleep(bool sleep);
+
+private:
+    struct Alarm {
+        int id = 0;
+        QDateTime dateTime;
+        QPointer<QObject> context;
+        std::function<void()> callback;
+    };
+
+    void watchSystemBus();
+    void slotTimeout();
+    void fireDueAlarms();
+    void rearm();
+
+    QList<Alarm> mAlarms;
+    int mNextId = 1;
+    int mTimerFd = -1;
+    QSocketNotifier *mNotifier = nullptr;
+    QTimer *mTimer = nullptr;
+    // Used to detect clock changes when there is no timerfd
+    QElapsedTimer mMonotonicClock;
+    qint64 mLastWallClock = 0;
+};
+}